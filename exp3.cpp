@@ -6,6 +6,34 @@
 #include <limits>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <type_traits>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>  // 文件映射
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h> // 文件映射
+#include <sys/stat.h>
+#endif
 using namespace std;
 
 const int INF = numeric_limits<int>::max();
@@ -269,46 +297,3247 @@ public:
     }
 };
 
+// 索引D叉最小堆：元素是0..capacity-1的整数，pos记录每个元素在堆数组中的位置，
+// 因此可以在O(log_D n)内减小任意元素的键值（decrease-key），不必像priority_queue那样重复入堆。
+// D取4时树高减半，一个结点的孩子相邻存放，sift-down时访存更集中
+template <typename Key, int D = 4>
+class IndexedDaryHeap {
+private:
+    vector<int> heap;
+    vector<int> pos;  // -1表示不在堆中
+    vector<Key> keys;
+
+    void siftUp(int i) {
+        int item = heap[i];
+        Key key = keys[item];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (!(key < keys[heap[parent]])) break;
+            heap[i] = heap[parent];
+            pos[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = item;
+        pos[item] = i;
+    }
+
+    void siftDown(int i) {
+        int item = heap[i];
+        Key key = keys[item];
+        int n = heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            int last = min(first + D, n);
+            for (int c = first + 1; c < last; c++) {
+                if (keys[heap[c]] < keys[heap[best]]) best = c;
+            }
+            if (!(keys[heap[best]] < key)) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = item;
+        pos[item] = i;
+    }
+
+public:
+    explicit IndexedDaryHeap(int capacity) : pos(capacity, -1), keys(capacity) {}
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    bool contains(int item) const {
+        return pos[item] != -1;
+    }
+
+    void push(int item, Key key) {
+        keys[item] = key;
+        heap.push_back(item);
+        siftUp(heap.size() - 1);
+    }
+
+    // key不能大于当前键值
+    void decreaseKey(int item, Key key) {
+        keys[item] = key;
+        siftUp(pos[item]);
+    }
+
+    // 扩大元素编号的范围，已在堆中的元素不受影响
+    void grow(int capacity) {
+        if (capacity > (int)pos.size()) {
+            pos.resize(capacity, -1);
+            keys.resize(capacity);
+        }
+    }
+
+    int top() const {
+        return heap[0];
+    }
+
+    int pop() {
+        int item = heap[0];
+        pos[item] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return item;
+    }
+};
+
+// 数据并行用的线程池：parallelFor把编号0..count-1的任务分给所有线程（含调用者），
+// 任务用原子计数器动态领取，全部完成后才返回。工作线程在两次调用之间休眠
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    const function<void(int, int)>* job;
+    int jobCount;
+    atomic<int> nextTask;
+    int running;
+    unsigned long long generation;
+    bool stopping;
+
+    void runTasks(int worker) {
+        int task;
+        while ((task = nextTask++) < jobCount) {
+            (*job)(task, worker);
+        }
+    }
+
+    void workerLoop(int worker) {
+        unsigned long long seen = 0;
+        while (true) {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            guard.unlock();
+
+            runTasks(worker);
+
+            guard.lock();
+            if (--running == 0) finished.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(int numThreads)
+        : job(nullptr), jobCount(0), nextTask(0), running(0), generation(0), stopping(false) {
+        for (int t = 1; t < numThreads; t++) {
+            workers.push_back(thread(&ThreadPool::workerLoop, this, t));
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // 参与计算的线程数（含调用者），body的第二个参数是线程编号，范围[0, size())
+    int size() const {
+        return workers.size() + 1;
+    }
+
+    void parallelFor(int count, const function<void(int, int)>& body) {
+        if (workers.empty() || count <= 1) {
+            for (int task = 0; task < count; task++) body(task, 0);
+            return;
+        }
+
+        {
+            lock_guard<mutex> guard(lock);
+            job = &body;
+            jobCount = count;
+            nextTask = 0;
+            running = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        runTasks(0);
+
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&] { return running == 0; });
+    }
+};
+
+// 原子位图：每个顶点一位。testAndSet用fetch_or，多个线程同时设置同一位时只有一个返回true
+class AtomicBitmap {
+private:
+    vector<atomic<unsigned long long>> words;
+
+public:
+    explicit AtomicBitmap(int n) : words((n + 63) / 64) {
+        clear();
+    }
+
+    void clear() {
+        for (auto& word : words) {
+            word.store(0, memory_order_relaxed);
+        }
+    }
+
+    int wordCount() const {
+        return words.size();
+    }
+
+    bool test(int i) const {
+        return (words[i >> 6].load(memory_order_relaxed) >> (i & 63)) & 1;
+    }
+
+    void set(int i) {
+        words[i >> 6].fetch_or(1ULL << (i & 63), memory_order_relaxed);
+    }
+
+    bool testAndSet(int i) {
+        unsigned long long bit = 1ULL << (i & 63);
+        if (words[i >> 6].load(memory_order_relaxed) & bit) return false;
+        return !(words[i >> 6].fetch_or(bit, memory_order_relaxed) & bit);
+    }
+
+    unsigned long long word(int w) const {
+        return words[w].load(memory_order_relaxed);
+    }
+
+    void orWord(int w, unsigned long long bits) {
+        words[w].fetch_or(bits, memory_order_relaxed);
+    }
+
+    void swap(AtomicBitmap& other) {
+        words.swap(other.words);
+    }
+};
+
+// 并查集：路径减半压缩 + 按秩合并，单次操作均摊接近O(1)
+class DisjointSet {
+private:
+    vector<int> parent;
+    vector<unsigned char> rank;
+    int sets;
+
+public:
+    explicit DisjointSet(int n = 0) {
+        reset(n);
+    }
+
+    void reset(int n) {
+        parent.resize(n);
+        for (int i = 0; i < n; i++) parent[i] = i;
+        rank.assign(n, 0);
+        sets = n;
+    }
+
+    int size() const {
+        return parent.size();
+    }
+
+    int setCount() const {
+        return sets;
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    // 已在同一集合时返回false
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        sets--;
+        return true;
+    }
+
+    // 新增一个单独成集合的元素，返回它的编号
+    int add() {
+        parent.push_back(parent.size());
+        rank.push_back(0);
+        sets++;
+        return parent.size() - 1;
+    }
+
+    bool connected(int a, int b) {
+        return find(a) == find(b);
+    }
+};
+
+// 只读文件映射：Linux用mmap，Windows用MapViewOfFile。sequential为true时提示内核按顺序预读
+class MappedFile {
+private:
+    const unsigned char* base;
+    size_t length;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+public:
+    MappedFile() : base(nullptr), length(0) {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path, bool sequential) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, NULL);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+            close();
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+        if (length == 0) return true;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) base = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // 映射建立后不再需要文件描述符
+        if (p != MAP_FAILED) {
+            base = (const unsigned char*)p;
+            madvise(p, length, sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+        }
+#endif
+        if (base == nullptr) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap((void*)base, length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    const unsigned char* data() const {
+        return base;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+// CSR快照文件（小端，各数组按64字节对齐），映射后邻接数组直接指向文件内容，不需要解析：
+//   128字节文件头（SnapshotHeader）
+//   offsets: vertexCount+1个int64；targets: arcCount个int32；weights: arcCount个权重；ids: vertexCount个顶点ID
+// 整数ID的图写入时按ID从小到大重新编号，读取时用ID列二分查找，ID连续时直接相减，都不需要建哈希表
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_SYMMETRIC = 1;      // 每条边存了两个方向
+const uint32_t SNAPSHOT_DENSE_IDS = 2;      // 第i个顶点的ID是ids[0] + i
+const uint32_t SNAPSHOT_FLOAT_WEIGHTS = 4;  // 权重是浮点数
+const uint32_t SNAPSHOT_SORTED_IDS = 8;     // ID列严格递增
+
+struct SnapshotHeader {
+    char magic[8];        // "CSRSNAP1"
+    uint32_t version;
+    uint32_t flags;
+    uint32_t idSize;      // sizeof(VertexId)
+    uint32_t weightSize;  // sizeof(Weight)
+    uint64_t vertexCount;
+    uint64_t arcCount;
+    uint64_t offsetsPos;  // 各数组起始的字节偏移
+    uint64_t targetsPos;
+    uint64_t weightsPos;
+    uint64_t idsPos;
+    unsigned char reserved[56];
+};
+static_assert(sizeof(SnapshotHeader) == 128, "snapshot header must be 128 bytes");
+
+// 整数顶点ID是连续的一段时，编号就是ID减去最小的ID
+template <typename VertexId>
+int denseIndex(const VertexId& vertex, const VertexId& first, int n) {
+    if constexpr (is_integral<VertexId>::value) {
+        if (vertex < first) return -1;
+        unsigned long long index = (unsigned long long)vertex - (unsigned long long)first;
+        return index < (unsigned long long)n ? (int)index : -1;
+    } else {
+        return -1;
+    }
+}
+
+// ID列有序时二分查找
+template <typename VertexId>
+int sortedIndex(const VertexId& vertex, const VertexId* ids, int n) {
+    if constexpr (is_integral<VertexId>::value) {
+        const VertexId* it = lower_bound(ids, ids + n, vertex);
+        return it != ids + n && *it == vertex ? (int)(it - ids) : -1;
+    } else {
+        return -1;
+    }
+}
+
+// 压缩稀疏行（CSR）存储的图：顶点可以是任意可哈希的ID，权重类型可以是任意算术类型。
+// 从边表一次性构建，之后不可修改；顶点u的邻居是targets[offsets[u], offsets[u+1])，
+// 内存为O(V+E)，遍历邻居是连续访存。顶点按在边表中首次出现的顺序编号，
+// 每个顶点的邻居保持边表中的顺序，因此遍历结果与Graph完全一致。
+template <typename VertexId, typename Weight = int>
+class CSRGraph {
+public:
+    struct Edge {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+    };
+
+    // 最小生成森林：图不连通时每个连通分量各有一棵树，edges.size() == V - trees
+    struct SpanningForest {
+        vector<Edge> edges;
+        Weight totalWeight;
+        int trees;
+    };
+
+    // BFS树：起点的parent是它自己，未到达的顶点parent和depth都是-1
+    struct BFSTree {
+        vector<int> parent;
+        vector<int> depth;
+        long long edgesExamined;  // 检查过的边数
+        int levels;
+        int bottomUpLevels;       // 其中自底向上处理的层数
+    };
+
+    // 单源最短路径：dist为infinity()表示不可达；pred是最短路径树中的前驱，起点和不可达顶点为-1
+    struct ShortestPaths {
+        vector<Weight> dist;
+        vector<int> pred;
+    };
+
+private:
+    // 邻接数组要么存放在下面几个vector中（从边表构建），要么直接指向映射的快照文件（loadSnapshot），
+    // 各算法只通过指针访问
+    vector<long long> offsetStorage;
+    vector<int> targetStorage;
+    vector<Weight> weightStorage;
+    vector<VertexId> idStorage;
+    shared_ptr<MappedFile> snapshot;
+    const long long* offsets;
+    const int* targets;
+    const Weight* weights;
+    const VertexId* indexToVertex;
+    int vertices;
+    long long arcs;
+    bool symmetric;  // 每条边都存了两个方向，自底向上BFS需要沿入边查找
+    bool denseIds;   // 第i个顶点的ID是indexToVertex[0] + i，不使用vertexMap
+    bool sortedIds;  // ID递增，二分查找，不使用vertexMap
+    unordered_map<VertexId, int> vertexMap;
+
+    int internVertex(const VertexId& vertex) {
+        auto it = vertexMap.find(vertex);
+        if (it != vertexMap.end()) return it->second;
+        int index = idStorage.size();
+        vertexMap.emplace(vertex, index);
+        idStorage.push_back(vertex);
+        return index;
+    }
+
+    void attachStorage() {
+        offsets = offsetStorage.data();
+        targets = targetStorage.data();
+        weights = weightStorage.data();
+        indexToVertex = idStorage.data();
+        vertices = idStorage.size();
+        arcs = targetStorage.size();
+    }
+
+public:
+    CSRGraph() : offsetStorage(1, 0), symmetric(true), denseIds(false), sortedIds(false) {
+        attachStorage();
+    }
+
+    // undirected为true时每条边存两个方向（与Graph::addEdge相同）
+    explicit CSRGraph(const vector<Edge>& edges, bool undirected = true) {
+        build(edges, undirected);
+    }
+
+    // 复制后指针要指向自己的vector；映射的快照由shared_ptr共享
+    CSRGraph(const CSRGraph& other)
+        : offsetStorage(other.offsetStorage), targetStorage(other.targetStorage),
+          weightStorage(other.weightStorage), idStorage(other.idStorage), snapshot(other.snapshot),
+          offsets(other.offsets), targets(other.targets), weights(other.weights),
+          indexToVertex(other.indexToVertex), vertices(other.vertices), arcs(other.arcs),
+          symmetric(other.symmetric), denseIds(other.denseIds), sortedIds(other.sortedIds),
+          vertexMap(other.vertexMap) {
+        if (!snapshot) attachStorage();
+    }
+
+    CSRGraph(CSRGraph&&) = default;
+    CSRGraph& operator=(CSRGraph&&) = default;
+
+    CSRGraph& operator=(const CSRGraph& other) {
+        if (this != &other) {
+            CSRGraph copy(other);
+            *this = move(copy);
+        }
+        return *this;
+    }
+
+    // vertexIds中的顶点先按给出的顺序登记，没有边的孤立顶点也会保留
+    void build(const vector<Edge>& edges, bool undirected = true, const vector<VertexId>& vertexIds = vector<VertexId>()) {
+        symmetric = undirected;
+        denseIds = false;
+        sortedIds = false;
+        snapshot.reset();
+        vertexMap.clear();
+        idStorage.clear();
+        vertexMap.reserve(max(edges.size(), vertexIds.size()));
+
+        for (const VertexId& vertex : vertexIds) internVertex(vertex);
+        vector<int> from(edges.size()), to(edges.size());
+        for (size_t i = 0; i < edges.size(); i++) {
+            from[i] = internVertex(edges[i].from);
+            to[i] = internVertex(edges[i].to);
+        }
+
+        // 计数排序：统计出度、求前缀和、按边表顺序写入
+        int n = idStorage.size();
+        offsetStorage.assign(n + 1, 0);
+        for (size_t i = 0; i < edges.size(); i++) {
+            offsetStorage[from[i] + 1]++;
+            if (undirected) offsetStorage[to[i] + 1]++;
+        }
+        for (int u = 0; u < n; u++) {
+            offsetStorage[u + 1] += offsetStorage[u];
+        }
+
+        targetStorage.resize(offsetStorage[n]);
+        weightStorage.resize(offsetStorage[n]);
+        vector<long long> next(offsetStorage.begin(), offsetStorage.end() - 1);
+        for (size_t i = 0; i < edges.size(); i++) {
+            long long e = next[from[i]]++;
+            targetStorage[e] = to[i];
+            weightStorage[e] = edges[i].weight;
+            if (undirected) {
+                e = next[to[i]]++;
+                targetStorage[e] = from[i];
+                weightStorage[e] = edges[i].weight;
+            }
+        }
+        attachStorage();
+    }
+
+    // 写成快照文件，之后可以用loadSnapshot直接映射。
+    // 整数ID不是递增顺序时先按ID重新编号（每个顶点的邻居顺序不变），多用一份O(V+E)的临时内存
+    bool writeSnapshot(const string& path) const {
+        ofstream out(path.c_str(), ios::binary);
+        if (!out) {
+            cerr << "Error: cannot write " << path << endl;
+            return false;
+        }
+
+        const long long* outOffsets = offsets;
+        const int* outTargets = targets;
+        const Weight* outWeights = weights;
+        const VertexId* outIds = indexToVertex;
+        vector<long long> sortedOffsets;
+        vector<int> sortedTargets;
+        vector<Weight> sortedWeights;
+        vector<VertexId> sortedIdList;
+        bool sorted = false;
+        bool dense = false;
+        if constexpr (is_integral<VertexId>::value) {
+            sorted = true;
+            for (int i = 1; i < vertices && sorted; i++) {
+                sorted = indexToVertex[i - 1] < indexToVertex[i];
+            }
+            if (!sorted) {
+                vector<int> order(vertices);
+                for (int i = 0; i < vertices; i++) order[i] = i;
+                sort(order.begin(), order.end(),
+                     [&](int a, int b) { return indexToVertex[a] < indexToVertex[b]; });
+                vector<int> rank(vertices);
+                for (int k = 0; k < vertices; k++) rank[order[k]] = k;
+
+                sortedOffsets.resize(vertices + 1);
+                sortedTargets.resize(arcs);
+                sortedWeights.resize(arcs);
+                sortedIdList.resize(vertices);
+                long long next = 0;
+                sortedOffsets[0] = 0;
+                for (int k = 0; k < vertices; k++) {
+                    int u = order[k];
+                    sortedIdList[k] = indexToVertex[u];
+                    for (long long e = offsets[u]; e < offsets[u + 1]; e++, next++) {
+                        sortedTargets[next] = rank[targets[e]];
+                        sortedWeights[next] = weights[e];
+                    }
+                    sortedOffsets[k + 1] = next;
+                }
+                outOffsets = sortedOffsets.data();
+                outTargets = sortedTargets.data();
+                outWeights = sortedWeights.data();
+                outIds = sortedIdList.data();
+                sorted = true;
+            }
+            dense = vertices == 0 || denseIndex(outIds[vertices - 1], outIds[0], vertices) == vertices - 1;
+        }
+
+        auto align = [](uint64_t pos) { return (pos + 63) / 64 * 64; };
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "CSRSNAP1", 8);
+        header.version = SNAPSHOT_VERSION;
+        header.flags = (symmetric ? SNAPSHOT_SYMMETRIC : 0) | (dense ? SNAPSHOT_DENSE_IDS : 0) |
+                       (sorted ? SNAPSHOT_SORTED_IDS : 0) |
+                       (is_floating_point<Weight>::value ? SNAPSHOT_FLOAT_WEIGHTS : 0);
+        header.idSize = sizeof(VertexId);
+        header.weightSize = sizeof(Weight);
+        header.vertexCount = vertices;
+        header.arcCount = arcs;
+        header.offsetsPos = align(sizeof(SnapshotHeader));
+        header.targetsPos = align(header.offsetsPos + (vertices + 1) * sizeof(long long));
+        header.weightsPos = align(header.targetsPos + arcs * sizeof(int));
+        header.idsPos = align(header.weightsPos + arcs * sizeof(Weight));
+
+        static const char padding[64] = {0};
+        uint64_t written = 0;
+        auto writeAt = [&](uint64_t pos, const void* data, uint64_t bytes) {
+            out.write(padding, pos - written);
+            out.write((const char*)data, bytes);
+            written = pos + bytes;
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.offsetsPos, outOffsets, (vertices + 1) * sizeof(long long));
+        writeAt(header.targetsPos, outTargets, arcs * sizeof(int));
+        writeAt(header.weightsPos, outWeights, arcs * sizeof(Weight));
+        writeAt(header.idsPos, outIds, vertices * sizeof(VertexId));
+
+        if (!out) {
+            cerr << "Error: failed writing " << path << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 映射快照文件：邻接数组不拷贝、不解析。返回前顺序扫描一遍检查offsets单调、targets都小于V、
+    // 权重非负、ID列确实有序，损坏的文件不会被接受；只有非整数ID的快照要用ID列重建哈希表
+    bool loadSnapshot(const string& path) {
+        shared_ptr<MappedFile> file = make_shared<MappedFile>();
+        if (!file->open(path, false)) {
+            cerr << "Error: cannot read " << path << endl;
+            return false;
+        }
+
+        const unsigned char* base = file->data();
+        uint64_t size = file->size();
+        SnapshotHeader header;
+        if (size < sizeof(header)) {
+            cerr << "Error: " << path << " is not a CSR snapshot file" << endl;
+            return false;
+        }
+        memcpy(&header, base, sizeof(header));
+        if (memcmp(header.magic, "CSRSNAP1", 8) != 0) {
+            cerr << "Error: " << path << " is not a CSR snapshot file" << endl;
+            return false;
+        }
+        bool floatWeights = (header.flags & SNAPSHOT_FLOAT_WEIGHTS) != 0;
+        if (header.version != SNAPSHOT_VERSION || header.idSize != sizeof(VertexId) ||
+            header.weightSize != sizeof(Weight) || floatWeights != is_floating_point<Weight>::value) {
+            cerr << "Error: " << path << " has an incompatible version or vertex/weight type" << endl;
+            return false;
+        }
+
+        auto fits = [&](uint64_t pos, uint64_t count, uint64_t elementSize) {
+            return pos % 8 == 0 && pos <= size && count <= (size - pos) / elementSize;
+        };
+        if (header.vertexCount >= (uint64_t)numeric_limits<int>::max() ||
+            !fits(header.offsetsPos, header.vertexCount + 1, sizeof(long long)) ||
+            !fits(header.targetsPos, header.arcCount, sizeof(int)) ||
+            !fits(header.weightsPos, header.arcCount, sizeof(Weight)) ||
+            !fits(header.idsPos, header.vertexCount, sizeof(VertexId))) {
+            cerr << "Error: " << path << " is truncated or corrupt" << endl;
+            return false;
+        }
+        const long long* mappedOffsets = (const long long*)(base + header.offsetsPos);
+        const int* mappedTargets = (const int*)(base + header.targetsPos);
+        const VertexId* mappedIds = (const VertexId*)(base + header.idsPos);
+        int n = header.vertexCount;
+        bool dense = (header.flags & SNAPSHOT_DENSE_IDS) != 0;
+        bool sorted = dense || (header.flags & SNAPSHOT_SORTED_IDS) != 0;
+        bool valid = mappedOffsets[0] == 0 && (uint64_t)mappedOffsets[n] == header.arcCount;
+        for (int i = 0; i < n && valid; i++) {
+            valid = mappedOffsets[i] <= mappedOffsets[i + 1];
+        }
+        const Weight* mappedWeights = (const Weight*)(base + header.weightsPos);
+        for (uint64_t e = 0; e < header.arcCount && valid; e++) {
+            valid = mappedTargets[e] >= 0 && mappedTargets[e] < n && !(mappedWeights[e] < 0);
+        }
+        if (sorted) {
+            valid = valid && is_integral<VertexId>::value;
+            for (int i = 1; i < n && valid; i++) {
+                valid = mappedIds[i - 1] < mappedIds[i];
+            }
+            if (dense && n > 0) {
+                valid = valid && denseIndex(mappedIds[n - 1], mappedIds[0], n) == n - 1;
+            }
+        }
+        if (!valid) {
+            cerr << "Error: " << path << " is truncated or corrupt" << endl;
+            return false;
+        }
+
+        offsetStorage.clear();
+        targetStorage.clear();
+        weightStorage.clear();
+        idStorage.clear();
+        vertexMap.clear();
+        snapshot = file;
+        offsets = mappedOffsets;
+        targets = mappedTargets;
+        weights = mappedWeights;
+        indexToVertex = mappedIds;
+        vertices = n;
+        arcs = header.arcCount;
+        symmetric = (header.flags & SNAPSHOT_SYMMETRIC) != 0;
+        denseIds = dense;
+        sortedIds = sorted;
+        if (!sortedIds) {
+            vertexMap.reserve(vertices);
+            for (int i = 0; i < vertices; i++) {
+                vertexMap.emplace(indexToVertex[i], i);
+            }
+        }
+        return true;
+    }
+
+    static Weight infinity() {
+        return numeric_limits<Weight>::max();
+    }
+
+    int vertexCount() const {
+        return vertices;
+    }
+
+    // 有向弧的数量（无向图每条边计两次）
+    long long arcCount() const {
+        return arcs;
+    }
+
+    bool isSymmetric() const {
+        return symmetric;
+    }
+
+    // 不存在的顶点返回-1
+    int indexOf(const VertexId& vertex) const {
+        if (denseIds) return vertices == 0 ? -1 : denseIndex(vertex, indexToVertex[0], vertices);
+        if (sortedIds) return sortedIndex(vertex, indexToVertex, vertices);
+        auto it = vertexMap.find(vertex);
+        return it == vertexMap.end() ? -1 : it->second;
+    }
+
+    const VertexId& vertexAt(int index) const {
+        return indexToVertex[index];
+    }
+
+    long long edgeBegin(int u) const {
+        return offsets[u];
+    }
+
+    long long edgeEnd(int u) const {
+        return offsets[u + 1];
+    }
+
+    int target(long long e) const {
+        return targets[e];
+    }
+
+    Weight weight(long long e) const {
+        return weights[e];
+    }
+
+    vector<VertexId> BFS(const VertexId& start) const {
+        vector<VertexId> result;
+        int startIndex = indexOf(start);
+        if (startIndex == -1) return result;
+
+        vector<bool> visited(vertexCount(), false);
+        vector<int> q;
+        q.push_back(startIndex);
+        visited[startIndex] = true;
+
+        for (size_t head = 0; head < q.size(); head++) {
+            int current = q[head];
+            result.push_back(indexToVertex[current]);
+
+            for (long long e = offsets[current]; e < offsets[current + 1]; e++) {
+                int neighbor = targets[e];
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    q.push_back(neighbor);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    int degree(int u) const {
+        return offsets[u + 1] - offsets[u];
+    }
+
+    // 方向优化的层同步并行BFS（Beamer等人的做法）。
+    // 自顶向下：前沿（顶点队列）中的每个顶点检查所有邻居，用visited位图的testAndSet认领未访问的邻居；
+    // 自底向上：每个未访问的顶点检查邻居中有没有在前沿（位图）里的，找到一个就停止。
+    // 前沿的出边数超过未探索边数的1/BFS_ALPHA时切换到自底向上，前沿开始缩小且不到V/BFS_BETA时切回。
+    // 低直径图中间几层前沿覆盖大部分顶点，自底向上能省掉绝大多数边检查。
+    // 自底向上要求图是对称的（无向图），否则始终自顶向下
+    BFSTree parallelBFS(const VertexId& start, ThreadPool& pool, bool directionOptimizing = true) const {
+        const int BFS_ALPHA = 15;
+        const int BFS_BETA = 18;
+        const int CHUNK = 256;
+        const int WORDS_PER_TASK = 64;
+
+        int n = vertexCount();
+        BFSTree tree;
+        tree.parent.assign(n, -1);
+        tree.depth.assign(n, -1);
+        tree.edgesExamined = 0;
+        tree.levels = 0;
+        tree.bottomUpLevels = 0;
+
+        int source = indexOf(start);
+        if (source == -1) return tree;
+
+        int threads = pool.size();
+        AtomicBitmap visited(n), frontierBits(n), nextBits(n);
+        vector<int> frontier(1, source);
+        vector<vector<int>> localNext(threads);
+        vector<long long> examined(threads), exploredEdges(threads), awake(threads);
+        visited.set(source);
+        tree.parent[source] = source;
+        tree.depth[source] = 0;
+
+        long long unexploredEdges = arcCount() - degree(source);
+        long long frontierSize = 1;
+        long long previousSize = 0;
+        bool bottomUp = false;
+        int level = 0;
+
+        while (frontierSize > 0) {
+            if (directionOptimizing && symmetric) {
+                if (!bottomUp) {
+                    long long frontierEdges = 0;
+                    for (int u : frontier) frontierEdges += degree(u);
+                    if (frontierEdges > unexploredEdges / BFS_ALPHA) {
+                        bottomUp = true;
+                        frontierBits.clear();
+                        for (int u : frontier) frontierBits.set(u);
+                    }
+                } else if (frontierSize < previousSize && frontierSize <= n / BFS_BETA) {
+                    bottomUp = false;
+                    frontier.clear();
+                    for (int w = 0; w < frontierBits.wordCount(); w++) {
+                        for (unsigned long long bits = frontierBits.word(w); bits; bits &= bits - 1) {
+                            frontier.push_back(w * 64 + __builtin_ctzll(bits));
+                        }
+                    }
+                }
+            }
+
+            previousSize = frontierSize;
+            fill(exploredEdges.begin(), exploredEdges.end(), 0);
+            if (bottomUp) {
+                // 每个任务负责连续的WORDS_PER_TASK个位图字，visited和next的这些字只由它写
+                nextBits.clear();
+                fill(awake.begin(), awake.end(), 0);
+                int words = visited.wordCount();
+                pool.parallelFor((words + WORDS_PER_TASK - 1) / WORDS_PER_TASK, [&](int task, int worker) {
+                    long long checked = 0, explored = 0, woken = 0;
+                    int wordEnd = min(words, (task + 1) * WORDS_PER_TASK);
+                    for (int w = task * WORDS_PER_TASK; w < wordEnd; w++) {
+                        unsigned long long found = 0;
+                        for (unsigned long long bits = ~visited.word(w); bits; bits &= bits - 1) {
+                            int bit = __builtin_ctzll(bits);
+                            int v = w * 64 + bit;
+                            if (v >= n) break;
+                            for (long long e = offsets[v]; e < offsets[v + 1]; e++) {
+                                checked++;
+                                int u = targets[e];
+                                if (frontierBits.test(u)) {
+                                    tree.parent[v] = u;
+                                    tree.depth[v] = level + 1;
+                                    found |= 1ULL << bit;
+                                    explored += degree(v);
+                                    break;
+                                }
+                            }
+                        }
+                        if (found) {
+                            nextBits.orWord(w, found);
+                            visited.orWord(w, found);
+                            woken += __builtin_popcountll(found);
+                        }
+                    }
+                    examined[worker] += checked;
+                    exploredEdges[worker] += explored;
+                    awake[worker] += woken;
+                });
+                frontierBits.swap(nextBits);
+                frontierSize = 0;
+                for (int t = 0; t < threads; t++) frontierSize += awake[t];
+                tree.bottomUpLevels++;
+            } else {
+                pool.parallelFor((frontier.size() + CHUNK - 1) / CHUNK, [&](int task, int worker) {
+                    long long explored = 0;
+                    size_t end = min(frontier.size(), (size_t)(task + 1) * CHUNK);
+                    for (size_t i = (size_t)task * CHUNK; i < end; i++) {
+                        int u = frontier[i];
+                        examined[worker] += degree(u);
+                        for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                            int v = targets[e];
+                            if (visited.testAndSet(v)) {
+                                tree.parent[v] = u;
+                                tree.depth[v] = level + 1;
+                                localNext[worker].push_back(v);
+                                explored += degree(v);
+                            }
+                        }
+                    }
+                    exploredEdges[worker] += explored;
+                });
+                frontier.clear();
+                for (int t = 0; t < threads; t++) {
+                    frontier.insert(frontier.end(), localNext[t].begin(), localNext[t].end());
+                    localNext[t].clear();
+                }
+                frontierSize = frontier.size();
+            }
+
+            for (int t = 0; t < threads; t++) unexploredEdges -= exploredEdges[t];
+            tree.levels++;
+            level++;
+        }
+
+        for (int t = 0; t < threads; t++) tree.edgesExamined += examined[t];
+        return tree;
+    }
+
+    // 用显式栈代替递归，访问顺序与递归版DFS相同；cursor[v]记录v下一条待检查的边
+    vector<VertexId> DFS(const VertexId& start) const {
+        vector<VertexId> result;
+        int startIndex = indexOf(start);
+        if (startIndex == -1) return result;
+
+        vector<bool> visited(vertexCount(), false);
+        vector<pair<int, long long>> st;
+        visited[startIndex] = true;
+        result.push_back(indexToVertex[startIndex]);
+        st.push_back({startIndex, offsets[startIndex]});
+
+        while (!st.empty()) {
+            int u = st.back().first;
+            long long& cursor = st.back().second;
+            while (cursor < offsets[u + 1] && visited[targets[cursor]]) {
+                cursor++;
+            }
+            if (cursor == offsets[u + 1]) {
+                st.pop_back();
+                continue;
+            }
+
+            int v = targets[cursor++];
+            visited[v] = true;
+            result.push_back(indexToVertex[v]);
+            st.push_back({v, offsets[v]});
+        }
+
+        return result;
+    }
+
+    // 二叉堆Dijkstra，O((V+E) log V)；权重须非负，0权重的边同样有效。
+    // priority_queue不支持decrease-key，同一顶点可能多次入堆，出堆时跳过过期的项
+    vector<pair<VertexId, Weight>> shortestPath(const VertexId& start) const {
+        int n = vertexCount();
+        vector<Weight> dist(n, infinity());
+        int startIndex = indexOf(start);
+
+        if (startIndex != -1) {
+            priority_queue<pair<Weight, int>, vector<pair<Weight, int>>, greater<pair<Weight, int>>> pq;
+            dist[startIndex] = 0;
+            pq.push({0, startIndex});
+
+            while (!pq.empty()) {
+                Weight d = pq.top().first;
+                int u = pq.top().second;
+                pq.pop();
+                if (d > dist[u]) continue;
+
+                for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                    int v = targets[e];
+                    Weight candidate = d + weights[e];
+                    if (candidate < dist[v]) {
+                        dist[v] = candidate;
+                        pq.push({candidate, v});
+                    }
+                }
+            }
+        }
+
+        vector<pair<VertexId, Weight>> result;
+        result.reserve(n);
+        for (int i = 0; i < n; i++) {
+            result.push_back({indexToVertex[i], dist[i]});
+        }
+        return result;
+    }
+
+    // 索引D叉堆Dijkstra，O((V+E) log V)，顶点用编号表示。
+    // target不为-1时，target出堆即停止：此时它的距离和前驱链已经确定，其他顶点的结果可能不是最终值
+    template <int D = 4>
+    ShortestPaths dijkstra(int source, int target = -1) const {
+        int n = vertexCount();
+        ShortestPaths result;
+        result.dist.assign(n, infinity());
+        result.pred.assign(n, -1);
+        if (source < 0 || source >= n) return result;
+
+        vector<Weight>& dist = result.dist;
+        IndexedDaryHeap<Weight, D> heap(n);
+        dist[source] = 0;
+        heap.push(source, 0);
+
+        while (!heap.empty()) {
+            int u = heap.pop();
+            if (u == target) break;
+
+            Weight d = dist[u];
+            for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                int v = targets[e];
+                Weight candidate = d + weights[e];
+                if (candidate < dist[v]) {
+                    dist[v] = candidate;
+                    result.pred[v] = u;
+                    // 权重非负，已出堆的顶点不会再被更新，不在堆中就说明是第一次到达
+                    if (heap.contains(v)) {
+                        heap.decreaseKey(v, candidate);
+                    } else {
+                        heap.push(v, candidate);
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // 沿前驱链还原从起点到target的路径，不可达时返回空
+    vector<VertexId> pathTo(const ShortestPaths& paths, int target) const {
+        vector<VertexId> path;
+        if (target < 0 || paths.dist[target] == infinity()) return path;
+        for (int v = target; v != -1; v = paths.pred[v]) {
+            path.push_back(indexToVertex[v]);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // 点到点最短路径，找到to即停止；不可达时返回空路径，length为infinity()
+    vector<VertexId> findPath(const VertexId& from, const VertexId& to, Weight& length) const {
+        int source = indexOf(from);
+        int target = indexOf(to);
+        length = infinity();
+        if (source == -1 || target == -1) return vector<VertexId>();
+
+        ShortestPaths paths = dijkstra(source, target);
+        length = paths.dist[target];
+        return pathTo(paths, target);
+    }
+
+    // 平均边权除以平均度数，约等于沿最短路径前进一步的典型增量，作为delta的默认值
+    Weight defaultDelta() const {
+        if (arcs == 0) return 1;
+        double total = 0;
+        for (long long e = 0; e < arcs; e++) total += weights[e];
+        double averageDegree = (double)arcs / vertexCount();
+        return max((Weight)1, (Weight)(total / arcs / averageDegree));
+    }
+
+    // 并行delta-stepping单源最短路径，返回与shortestPath相同的距离（不含前驱）。
+    // 距离在[i*delta, (i+1)*delta)内的顶点放在桶i，按编号从小到大处理桶。权重不超过delta的是轻边，
+    // 松弛后可能落回当前桶，所以当前桶反复取出、只松弛轻边，直到为空；然后对这个桶里处理过的顶点
+    // 各松弛一次重边（重边一定落到后面的桶）。松弛由线程池并行，距离用CAS取最小值。
+    // 桶是固定数量的循环数组：一轮覆盖[base, base + RING)个桶，超出这一轮的顶点先放进溢出表，
+    // 这一轮处理完后再按距离放回，内存与最大距离无关。每个线程有自己的一组桶，不需要加锁；
+    // 一个顶点可能在多个桶里，处理时距离已不属于该桶就跳过。
+    // delta越小越接近Dijkstra（重复松弛少、轮数多），越大并行度越高但重复松弛越多
+    vector<Weight> deltaStepping(const VertexId& start, Weight delta, ThreadPool& pool) const {
+        const int CHUNK = 256;
+        const size_t RING_LIMIT = 1024;
+        const size_t NONE = numeric_limits<size_t>::max();
+        int n = vertexCount();
+        int threads = pool.size();
+        vector<atomic<Weight>> dist(n);
+        vector<atomic<size_t>> settledBucket(n);  // 顶点最近一次在哪个桶里被处理，重边阶段去重
+        for (int i = 0; i < n; i++) {
+            dist[i].store(infinity(), memory_order_relaxed);
+            settledBucket[i].store(NONE, memory_order_relaxed);
+        }
+
+        int source = indexOf(start);
+        if (source == -1 || delta <= 0) {
+            return vector<Weight>(n, infinity());
+        }
+
+        // 环的大小：一次松弛最多前进maxWeight/delta个桶，够用时溢出表只在一轮结束时周转一次
+        Weight maxWeight = 0;
+        for (long long e = 0; e < arcs; e++) {
+            maxWeight = max(maxWeight, weights[e]);
+        }
+        size_t ring = min(RING_LIMIT, (size_t)(maxWeight / delta) + 2);
+
+        vector<vector<vector<int>>> bins(threads, vector<vector<int>>(ring));
+        vector<vector<int>> overflow(threads);
+        vector<vector<int>> settled(threads);
+        size_t base = 0;
+        size_t bucket = 0;
+        vector<int> frontier(1, source);
+        dist[source].store(0, memory_order_relaxed);
+
+        auto place = [&](int v, Weight d, int worker) {
+            size_t b = (size_t)(d / delta);
+            if (b < base + ring) {
+                bins[worker][b % ring].push_back(v);
+            } else {
+                overflow[worker].push_back(v);
+            }
+        };
+        auto relax = [&](int u, Weight du, bool light, int worker) {
+            for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                if ((weights[e] <= delta) != light) continue;
+                int v = targets[e];
+                Weight candidate = du + weights[e];
+                Weight old = dist[v].load(memory_order_relaxed);
+                while (candidate < old) {
+                    if (dist[v].compare_exchange_weak(old, candidate, memory_order_relaxed)) {
+                        place(v, candidate, worker);
+                        break;
+                    }
+                }
+            }
+        };
+        auto relaxLight = [&](int task, int worker) {
+            size_t end = min(frontier.size(), (size_t)(task + 1) * CHUNK);
+            for (size_t i = (size_t)task * CHUNK; i < end; i++) {
+                int u = frontier[i];
+                Weight du = dist[u].load(memory_order_relaxed);
+                if ((size_t)(du / delta) != bucket) continue;
+                if (settledBucket[u].exchange(bucket, memory_order_relaxed) != bucket) {
+                    settled[worker].push_back(u);
+                }
+                relax(u, du, true, worker);
+            }
+        };
+        auto relaxHeavy = [&](int task, int worker) {
+            size_t end = min(frontier.size(), (size_t)(task + 1) * CHUNK);
+            for (size_t i = (size_t)task * CHUNK; i < end; i++) {
+                int u = frontier[i];
+                relax(u, dist[u].load(memory_order_relaxed), false, worker);
+            }
+        };
+        // 把各线程的某个桶（或列表）合并成新的前沿
+        auto gather = [&](vector<vector<int>*> lists) {
+            frontier.clear();
+            for (vector<int>* list : lists) {
+                frontier.insert(frontier.end(), list->begin(), list->end());
+                list->clear();
+            }
+        };
+        auto slotLists = [&](size_t b) {
+            vector<vector<int>*> lists;
+            for (int t = 0; t < threads; t++) lists.push_back(&bins[t][b % ring]);
+            return lists;
+        };
+
+        while (true) {
+            while (!frontier.empty()) {
+                pool.parallelFor((frontier.size() + CHUNK - 1) / CHUNK, relaxLight);
+                gather(slotLists(bucket));
+            }
+
+            vector<vector<int>*> settledLists;
+            for (int t = 0; t < threads; t++) settledLists.push_back(&settled[t]);
+            gather(settledLists);
+            if (!frontier.empty()) pool.parallelFor((frontier.size() + CHUNK - 1) / CHUNK, relaxHeavy);
+
+            // 这一轮中下一个非空桶
+            auto slotEmpty = [&](size_t b) {
+                for (int t = 0; t < threads; t++) {
+                    if (!bins[t][b % ring].empty()) return false;
+                }
+                return true;
+            };
+            for (bucket++; bucket < base + ring && slotEmpty(bucket); bucket++) {
+            }
+            if (bucket < base + ring) {
+                gather(slotLists(bucket));
+                continue;
+            }
+
+            // 这一轮结束：从溢出表中最小的距离开始下一轮，已处理过的过时项丢弃
+            size_t roundEnd = base + ring;
+            size_t next = NONE;
+            vector<int> pending;
+            for (int t = 0; t < threads; t++) {
+                for (int v : overflow[t]) {
+                    size_t b = (size_t)(dist[v].load(memory_order_relaxed) / delta);
+                    if (b >= roundEnd) {
+                        pending.push_back(v);
+                        next = min(next, b);
+                    }
+                }
+                overflow[t].clear();
+            }
+            if (next == NONE) break;
+            base = bucket = next;
+            for (int v : pending) {
+                place(v, dist[v].load(memory_order_relaxed), 0);
+            }
+            gather(slotLists(bucket));
+        }
+
+        vector<Weight> result(n);
+        for (int i = 0; i < n; i++) {
+            result[i] = dist[i].load(memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // Kruskal：所有边按(权重, 端点)排序后依次加入，并查集判断是否成环。
+    // 0权重和负权重的边都是普通的边；不连通时得到最小生成森林
+    SpanningForest kruskalMST() const {
+        struct WeightedPair {
+            Weight weight;
+            int u;
+            int v;
+            bool operator<(const WeightedPair& other) const {
+                if (weight != other.weight) return weight < other.weight;
+                if (u != other.u) return u < other.u;
+                return v < other.v;
+            }
+        };
+
+        int n = vertexCount();
+        vector<WeightedPair> edges;
+        edges.reserve(symmetric ? arcs / 2 : arcs);
+        for (int u = 0; u < n; u++) {
+            for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                int v = targets[e];
+                if (symmetric ? u < v : u != v) {
+                    edges.push_back({weights[e], u, v});
+                }
+            }
+        }
+        sort(edges.begin(), edges.end());
+
+        SpanningForest forest;
+        forest.totalWeight = 0;
+        DisjointSet sets(n);
+        for (const auto& edge : edges) {
+            if (sets.unite(edge.u, edge.v)) {
+                forest.edges.push_back({indexToVertex[edge.u], indexToVertex[edge.v], edge.weight});
+                forest.totalWeight += edge.weight;
+                if (sets.setCount() == 1) break;
+            }
+        }
+        forest.trees = sets.setCount();
+        return forest;
+    }
+
+    // 并行Borůvka：每轮所有分量同时选出连向其他分量的最轻边，一起合并，至多log2(V)轮。
+    // 找最轻边占了几乎全部时间，由线程池按顶点分块并行，用CAS把每个顶点的候选弧写入所属分量；
+    // 边按(权重, 较小端点, 较大端点, 弧编号)全序比较，保证同时选出的边不会成环，结果也与分量的处理顺序无关。
+    // 有向图与kruskalMST一样把每条弧当作无向边：弧u->v只在u的出边里，所以还要同时提交给v所在的分量。
+    // 合并和重新标号是顺序的
+    SpanningForest boruvkaMST(ThreadPool& pool) const {
+        const int CHUNK = 1024;
+        int n = vertexCount();
+
+        // 每条弧的起点，比较时按端点决胜
+        vector<int> source(arcs);
+        pool.parallelFor((n + CHUNK - 1) / CHUNK, [&](int task, int) {
+            int end = min(n, (task + 1) * CHUNK);
+            for (int u = task * CHUNK; u < end; u++) {
+                for (long long e = offsets[u]; e < offsets[u + 1]; e++) source[e] = u;
+            }
+        });
+        auto lighter = [&](long long a, long long b) {
+            if (weights[a] != weights[b]) return weights[a] < weights[b];
+            int a1 = min(source[a], targets[a]), a2 = max(source[a], targets[a]);
+            int b1 = min(source[b], targets[b]), b2 = max(source[b], targets[b]);
+            if (a1 != b1) return a1 < b1;
+            if (a2 != b2) return a2 < b2;
+            return a < b;
+        };
+
+        SpanningForest forest;
+        forest.totalWeight = 0;
+        DisjointSet sets(n);
+        vector<int> component(n);
+        for (int u = 0; u < n; u++) component[u] = u;
+        vector<atomic<long long>> best(n);
+
+        while (true) {
+            for (int u = 0; u < n; u++) {
+                best[u].store(-1, memory_order_relaxed);
+            }
+
+            auto offer = [&](int c, long long candidate) {
+                long long current = best[c].load(memory_order_relaxed);
+                while (current == -1 || lighter(candidate, current)) {
+                    if (best[c].compare_exchange_weak(current, candidate, memory_order_relaxed)) break;
+                }
+            };
+            pool.parallelFor((n + CHUNK - 1) / CHUNK, [&](int task, int) {
+                int end = min(n, (task + 1) * CHUNK);
+                for (int u = task * CHUNK; u < end; u++) {
+                    int cu = component[u];
+                    long long candidate = -1;
+                    for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                        int cv = component[targets[e]];
+                        if (cv == cu) continue;
+                        if (candidate == -1 || lighter(e, candidate)) candidate = e;
+                        if (!symmetric) offer(cv, e);
+                    }
+                    if (candidate != -1) offer(cu, candidate);
+                }
+            });
+
+            bool merged = false;
+            for (int c = 0; c < n; c++) {
+                long long e = best[c].load(memory_order_relaxed);
+                if (e == -1) continue;
+                if (sets.unite(source[e], targets[e])) {
+                    forest.edges.push_back({indexToVertex[source[e]], indexToVertex[targets[e]], weights[e]});
+                    forest.totalWeight += weights[e];
+                    merged = true;
+                }
+            }
+            if (!merged) break;
+
+            for (int u = 0; u < n; u++) {
+                component[u] = sets.find(u);
+            }
+        }
+
+        forest.trees = sets.setCount();
+        return forest;
+    }
+
+    // 堆优化的Prim。与Graph::primMST一样，一棵树长完后从编号最小的未加入顶点继续，
+    // 得到最小生成森林；key只在严格变小时更新，平局时的父节点选择与Graph相同
+    vector<pair<VertexId, VertexId>> primMST(const VertexId& start) const {
+        int n = vertexCount();
+        vector<Weight> key(n, infinity());
+        vector<int> parent(n, -1);
+        vector<bool> inMST(n, false);
+        priority_queue<pair<Weight, int>, vector<pair<Weight, int>>, greater<pair<Weight, int>>> pq;
+
+        int startIndex = indexOf(start);
+        int nextRoot = 0;
+        int root = startIndex != -1 ? startIndex : 0;
+        while (root < n) {
+            key[root] = 0;
+            pq.push({0, root});
+
+            while (!pq.empty()) {
+                int u = pq.top().second;
+                Weight k = pq.top().first;
+                pq.pop();
+                if (inMST[u] || k != key[u]) continue;
+                inMST[u] = true;
+
+                for (long long e = offsets[u]; e < offsets[u + 1]; e++) {
+                    int v = targets[e];
+                    if (!inMST[v] && weights[e] < key[v]) {
+                        key[v] = weights[e];
+                        parent[v] = u;
+                        pq.push({key[v], v});
+                    }
+                }
+            }
+
+            while (nextRoot < n && inMST[nextRoot]) nextRoot++;
+            root = nextRoot;
+        }
+
+        vector<pair<VertexId, VertexId>> result;
+        for (int i = 0; i < n; i++) {
+            if (parent[i] != -1) {
+                result.push_back({indexToVertex[parent[i]], indexToVertex[i]});
+            }
+        }
+        return result;
+    }
+
+    // 迭代Tarjan算法求双连通分量、关节点和桥，顶点用编号表示，判定逻辑与Graph::findBCC相同。
+    // 每找到一个分量就调用onComponent(edges, count)，edges是边栈中该分量的连续一段（按入栈顺序），
+    // 回调返回后这些边即出栈，不必同时保存所有分量。articulation、bridges为nullptr时不输出。
+    // 栈帧只有顶点、边游标和是否已跳过回到父节点的边：父节点就是下面一帧的顶点，只有根需要数孩子。
+    // 除输出外只需要disc、low两个数组，加上不超过V个栈帧和不超过E条边的边栈。
+    // 回到父节点的边只跳过一次，所以重边会正确地被当作环，不会被误报为桥
+    void biconnectedComponents(const function<void(const pair<int, int>*, size_t)>& onComponent,
+                               vector<bool>* articulation, vector<pair<int, int>>* bridges) const {
+        struct Frame {
+            int u;
+            bool skippedParent;
+            long long edge;
+        };
+
+        int n = vertexCount();
+        vector<int> disc(n, -1);
+        vector<int> low(n, -1);
+        vector<pair<int, int>> st;
+        vector<Frame> frames;
+        int time = 0;
+        if (articulation) articulation->assign(n, false);
+        if (bridges) bridges->clear();
+
+        // 弹出边栈顶到until（含）为止的边作为一个分量
+        auto popComponent = [&](pair<int, int> until) {
+            size_t begin = st.size();
+            while (begin > 0 && st[begin - 1] != until) begin--;
+            if (begin > 0) begin--;
+            onComponent(st.data() + begin, st.size() - begin);
+            st.resize(begin);
+        };
+
+        for (int root = 0; root < n; root++) {
+            if (disc[root] != -1) continue;
+
+            int rootChildren = 0;
+            disc[root] = low[root] = ++time;
+            frames.push_back({root, true, offsets[root]});
+            while (!frames.empty()) {
+                Frame& f = frames.back();
+                int u = f.u;
+
+                if (f.edge < offsets[u + 1]) {
+                    int v = targets[f.edge++];
+                    int parent = frames.size() > 1 ? frames[frames.size() - 2].u : -1;
+                    if (disc[v] == -1) {
+                        if (parent == -1) rootChildren++;
+                        st.push_back({u, v});
+                        disc[v] = low[v] = ++time;
+                        frames.push_back({v, false, offsets[v]});
+                    } else if (v == parent && !f.skippedParent) {
+                        f.skippedParent = true;
+                    } else if (disc[v] < disc[u]) {
+                        low[u] = min(low[u], disc[v]);
+                        st.push_back({u, v});
+                    }
+                    continue;
+                }
+
+                // u的所有边处理完，相当于递归返回到父节点p
+                frames.pop_back();
+                if (frames.empty()) break;
+                int p = frames.back().u;
+                bool pIsRoot = frames.size() == 1;
+                low[p] = min(low[p], low[u]);
+                if (bridges && low[u] > disc[p]) {
+                    bridges->push_back({p, u});
+                }
+                if ((pIsRoot && rootChildren > 1) || (!pIsRoot && low[u] >= disc[p])) {
+                    if (articulation) (*articulation)[p] = true;
+                    popComponent({p, u});
+                }
+            }
+
+            if (!st.empty()) {
+                popComponent({-1, -1});
+            }
+        }
+    }
+
+    // 双连通分量与关节点，结果（包括分量和分量内边的顺序）与Graph::findBCCAndArticulationPoints相同
+    pair<vector<vector<pair<VertexId, VertexId>>>, set<VertexId>> findBCCAndArticulationPoints() const {
+        vector<vector<pair<VertexId, VertexId>>> bcc;
+        vector<bool> articulation;
+        biconnectedComponents([&](const pair<int, int>* edges, size_t count) {
+            vector<pair<VertexId, VertexId>> component;
+            component.reserve(count);
+            for (size_t i = count; i-- > 0;) {
+                component.push_back({indexToVertex[edges[i].first], indexToVertex[edges[i].second]});
+            }
+            bcc.push_back(component);
+        }, &articulation, nullptr);
+
+        set<VertexId> ap;
+        for (int i = 0; i < vertexCount(); i++) {
+            if (articulation[i]) {
+                ap.insert(indexToVertex[i]);
+            }
+        }
+
+        return {bcc, ap};
+    }
+
+    // 桥：删除后连通分量数增加的边，以(DFS树中的父, 子)给出
+    vector<pair<VertexId, VertexId>> findBridges() const {
+        vector<pair<int, int>> bridges;
+        biconnectedComponents([](const pair<int, int>*, size_t) {}, nullptr, &bridges);
+
+        vector<pair<VertexId, VertexId>> result;
+        result.reserve(bridges.size());
+        for (const auto& edge : bridges) {
+            result.push_back({indexToVertex[edge.first], indexToVertex[edge.second]});
+        }
+        return result;
+    }
+};
+
+
+// 可修改的无向图：支持插入、删除边和修改权重，并增量维护从指定起点出发的最短距离和连通分量。
+// 邻接表是vector<vector<Arc>>，删除时与末尾交换；同一对顶点之间至多一条边，不允许自环，权重须非负。
+// 最短距离（Ramalingam-Reps式的增量算法），更新的代价只与受影响的顶点有关：
+//   - 边变短或新增：只有经过这条边能变短的顶点需要更新，从变短的端点开始做局部Dijkstra；
+//   - 边变长或删除：不在最短路径树上时什么都不变；在树上时只有子树里的顶点受影响，
+//     先把子树的距离置为无穷，再用子树外邻居给出的距离作为初值，只在子树内做局部Dijkstra。
+// 连通分量：并查集处理合并。删除边后若两端仍都能从起点到达，则一定仍然连通；否则从两端交替BFS，
+//   先走完的一侧（较小的一侧）就是断开的分量，把它的顶点换成并查集中的新元素。
+//   旧元素留在原集合里不影响计数，积累到顶点数以上时整体重建。
+template <typename VertexId, typename Weight = int>
+class DynamicGraph {
+public:
+    struct Arc {
+        int to;
+        Weight weight;
+    };
+
+private:
+    vector<vector<Arc>> adj;
+    unordered_map<VertexId, int> vertexMap;
+    vector<VertexId> indexToVertex;
+    long long edges;
+
+    int source;               // -1表示未指定起点，不维护最短距离
+    vector<Weight> dist;
+    vector<int> parent;       // 最短路径树中的父节点
+    IndexedDaryHeap<Weight, 4> heap;
+
+    DisjointSet components;
+    vector<int> node;         // 顶点在并查集中的当前元素
+
+    vector<int> mark;         // 局部搜索的访问标记，每次搜索换新的epoch，不必清空
+    int epoch;
+    vector<int> scratch;
+    long long lastTouched;    // 最近一次更新中重新计算或访问过的顶点数
+
+    static Weight infinity() {
+        return numeric_limits<Weight>::max();
+    }
+
+    int findArc(int u, int v) const {
+        for (int i = 0; i < (int)adj[u].size(); i++) {
+            if (adj[u][i].to == v) return i;
+        }
+        return -1;
+    }
+
+    void eraseArc(int u, int i) {
+        adj[u][i] = adj[u].back();
+        adj[u].pop_back();
+    }
+
+    int nextEpoch() {
+        epoch += 2;
+        return epoch;
+    }
+
+    // 堆中是距离被改小的顶点，按Dijkstra的顺序继续松弛；只会改动确实变短的顶点
+    void runDijkstra() {
+        while (!heap.empty()) {
+            int x = heap.pop();
+            lastTouched++;
+            for (const Arc& arc : adj[x]) {
+                Weight candidate = dist[x] + arc.weight;
+                if (candidate < dist[arc.to]) {
+                    dist[arc.to] = candidate;
+                    parent[arc.to] = x;
+                    if (heap.contains(arc.to)) {
+                        heap.decreaseKey(arc.to, candidate);
+                    } else {
+                        heap.push(arc.to, candidate);
+                    }
+                }
+            }
+        }
+    }
+
+    // 边u-v变短或新增
+    void relaxEdge(int u, int v, Weight w) {
+        if (source == -1) return;
+        if (dist[u] != infinity() && dist[u] + w < dist[v]) {
+            dist[v] = dist[u] + w;
+            parent[v] = u;
+            heap.push(v, dist[v]);
+        } else if (dist[v] != infinity() && dist[v] + w < dist[u]) {
+            dist[u] = dist[v] + w;
+            parent[u] = v;
+            heap.push(u, dist[u]);
+        }
+        runDijkstra();
+    }
+
+    // 边u-v变长或被删除（调用前邻接表已经更新）
+    void repairEdge(int u, int v) {
+        if (source == -1) return;
+        if (parent[v] == u) {
+            repairSubtree(v);
+        } else if (parent[u] == v) {
+            repairSubtree(u);
+        }
+    }
+
+    // 最短路径树中root的子树：树上的孩子一定是邻居，沿parent指针即可找出
+    void repairSubtree(int root) {
+        int stamp = nextEpoch();
+        vector<int>& subtree = scratch;
+        subtree.assign(1, root);
+        mark[root] = stamp;
+        for (size_t i = 0; i < subtree.size(); i++) {
+            int x = subtree[i];
+            for (const Arc& arc : adj[x]) {
+                if (parent[arc.to] == x && mark[arc.to] != stamp) {
+                    mark[arc.to] = stamp;
+                    subtree.push_back(arc.to);
+                }
+            }
+        }
+
+        for (int x : subtree) {
+            dist[x] = infinity();
+            parent[x] = -1;
+        }
+        // 子树外的距离不受影响，作为子树内顶点的初值
+        for (int x : subtree) {
+            for (const Arc& arc : adj[x]) {
+                int y = arc.to;
+                if (mark[y] != stamp && dist[y] != infinity() && dist[y] + arc.weight < dist[x]) {
+                    dist[x] = dist[y] + arc.weight;
+                    parent[x] = y;
+                }
+            }
+            if (dist[x] != infinity()) heap.push(x, dist[x]);
+        }
+        lastTouched += subtree.size();
+        runDijkstra();
+    }
+
+    // 删除边u-v后检查两端是否仍连通，断开时较小的一侧换到并查集的新集合
+    void splitIfDisconnected(int u, int v) {
+        if (source != -1 && dist[u] != infinity() && dist[v] != infinity()) return;
+
+        int stamp = nextEpoch();
+        vector<int> sides[2] = {vector<int>(1, u), vector<int>(1, v)};
+        size_t heads[2] = {0, 0};
+        mark[u] = stamp;
+        mark[v] = stamp + 1;
+
+        while (true) {
+            for (int side = 0; side < 2; side++) {
+                vector<int>& queue = sides[side];
+                if (heads[side] == queue.size()) {
+                    // 这一侧已经走完，是一个独立的分量
+                    lastTouched += sides[0].size() + sides[1].size();
+                    int fresh = components.add();
+                    for (int x : queue) {
+                        node[x] = fresh;
+                    }
+                    if (components.size() > 2 * vertexCount() + 1024) rebuildComponents();
+                    return;
+                }
+
+                int x = queue[heads[side]++];
+                for (const Arc& arc : adj[x]) {
+                    int y = arc.to;
+                    if (mark[y] == stamp + (1 - side)) {
+                        lastTouched += sides[0].size() + sides[1].size();
+                        return;  // 两侧相遇，仍然连通
+                    }
+                    if (mark[y] != stamp + side) {
+                        mark[y] = stamp + side;
+                        queue.push_back(y);
+                    }
+                }
+            }
+        }
+    }
+
+    void rebuildComponents() {
+        int n = vertexCount();
+        components.reset(n);
+        for (int u = 0; u < n; u++) {
+            node[u] = u;
+            for (const Arc& arc : adj[u]) {
+                if (u < arc.to) components.unite(u, arc.to);
+            }
+        }
+    }
+
+    int vertexIndex(const VertexId& vertex) const {
+        auto it = vertexMap.find(vertex);
+        return it == vertexMap.end() ? -1 : it->second;
+    }
+
+public:
+    DynamicGraph() : edges(0), source(-1), heap(0), epoch(0), lastTouched(0) {}
+
+    int vertexCount() const {
+        return indexToVertex.size();
+    }
+
+    long long edgeCount() const {
+        return edges;
+    }
+
+    // 顶点不存在时加入，返回编号
+    int addVertex(const VertexId& vertex) {
+        auto it = vertexMap.find(vertex);
+        if (it != vertexMap.end()) return it->second;
+
+        int index = indexToVertex.size();
+        vertexMap.emplace(vertex, index);
+        indexToVertex.push_back(vertex);
+        adj.emplace_back();
+        dist.push_back(infinity());
+        parent.push_back(-1);
+        mark.push_back(0);
+        node.push_back(components.add());
+        heap.grow(index + 1);
+        return index;
+    }
+
+    // 已有这条边、自环或负权重时返回false
+    bool insertEdge(const VertexId& a, const VertexId& b, Weight w) {
+        if (w < 0 || a == b) return false;
+        int u = addVertex(a);
+        int v = addVertex(b);
+        if (findArc(u, v) != -1) return false;
+
+        lastTouched = 0;
+        adj[u].push_back({v, w});
+        adj[v].push_back({u, w});
+        edges++;
+        components.unite(node[u], node[v]);
+        relaxEdge(u, v, w);
+        return true;
+    }
+
+    // 没有这条边时返回false
+    bool removeEdge(const VertexId& a, const VertexId& b) {
+        int u = vertexIndex(a);
+        int v = vertexIndex(b);
+        if (u == -1 || v == -1) return false;
+        int i = findArc(u, v);
+        if (i == -1) return false;
+
+        lastTouched = 0;
+        eraseArc(u, i);
+        eraseArc(v, findArc(v, u));
+        edges--;
+        repairEdge(u, v);
+        splitIfDisconnected(u, v);
+        return true;
+    }
+
+    // 没有这条边或权重为负时返回false
+    bool setWeight(const VertexId& a, const VertexId& b, Weight w) {
+        int u = vertexIndex(a);
+        int v = vertexIndex(b);
+        if (w < 0 || u == -1 || v == -1) return false;
+        int i = findArc(u, v);
+        if (i == -1) return false;
+
+        lastTouched = 0;
+        Weight old = adj[u][i].weight;
+        adj[u][i].weight = w;
+        adj[v][findArc(v, u)].weight = w;
+        if (w < old) {
+            relaxEdge(u, v, w);
+        } else if (w > old) {
+            repairEdge(u, v);
+        }
+        return true;
+    }
+
+    // 指定起点并完整计算一次最短距离，之后的修改都增量维护
+    void setSource(const VertexId& start) {
+        source = addVertex(start);
+        fill(dist.begin(), dist.end(), infinity());
+        fill(parent.begin(), parent.end(), -1);
+        lastTouched = 0;
+        dist[source] = 0;
+        heap.push(source, 0);
+        runDijkstra();
+    }
+
+    // 到起点的最短距离，不可达或未指定起点时为infinity()
+    Weight distance(const VertexId& vertex) const {
+        int v = vertexIndex(vertex);
+        return v == -1 ? infinity() : dist[v];
+    }
+
+    // 从起点到vertex的最短路径，不可达时为空
+    vector<VertexId> pathTo(const VertexId& vertex) const {
+        vector<VertexId> path;
+        int v = vertexIndex(vertex);
+        if (v == -1 || dist[v] == infinity()) return path;
+        for (; v != -1; v = parent[v]) {
+            path.push_back(indexToVertex[v]);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    bool connected(const VertexId& a, const VertexId& b) {
+        int u = vertexIndex(a);
+        int v = vertexIndex(b);
+        if (u == -1 || v == -1) return false;
+        return components.connected(node[u], node[v]);
+    }
+
+    int componentCount() const {
+        return components.setCount();
+    }
+
+    // 最近一次修改中重新计算或访问过的顶点数
+    long long touchedVertices() const {
+        return lastTouched;
+    }
+
+    // 不用增量信息、从头计算的最短距离和连通分量标号，用于检查和比较
+    vector<Weight> recomputeDistances() const {
+        int n = vertexCount();
+        vector<Weight> result(n, infinity());
+        if (source == -1) return result;
+        IndexedDaryHeap<Weight, 4> fresh(n);
+        result[source] = 0;
+        fresh.push(source, 0);
+        while (!fresh.empty()) {
+            int x = fresh.pop();
+            for (const Arc& arc : adj[x]) {
+                Weight candidate = result[x] + arc.weight;
+                if (candidate < result[arc.to]) {
+                    result[arc.to] = candidate;
+                    if (fresh.contains(arc.to)) {
+                        fresh.decreaseKey(arc.to, candidate);
+                    } else {
+                        fresh.push(arc.to, candidate);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    vector<int> componentLabels() const {
+        int n = vertexCount();
+        vector<int> label(n, -1);
+        int next = 0;
+        vector<int> q;
+        for (int s = 0; s < n; s++) {
+            if (label[s] != -1) continue;
+            label[s] = next;
+            q.assign(1, s);
+            for (size_t head = 0; head < q.size(); head++) {
+                for (const Arc& arc : adj[q[head]]) {
+                    if (label[arc.to] == -1) {
+                        label[arc.to] = next;
+                        q.push_back(arc.to);
+                    }
+                }
+            }
+            next++;
+        }
+        return label;
+    }
+
+    const vector<Weight>& distances() const {
+        return dist;
+    }
+
+    const VertexId& vertexAt(int index) const {
+        return indexToVertex[index];
+    }
+
+    int degree(int index) const {
+        return adj[index].size();
+    }
+
+    const Arc& arcAt(int index, int i) const {
+        return adj[index][i];
+    }
+};
+
+// 作业中的两张图，Graph和CSRGraph都从这里的边表构建
+vector<CSRGraph<char>::Edge> graph1Edges() {
+    return {
+        {'A', 'B', 6},
+        {'A', 'D', 2},
+        {'A', 'G', 4},
+        {'B', 'E', 9},
+        {'B', 'C', 13},
+        {'C', 'F', 11},
+        {'D', 'E', 14},
+        {'D', 'G', 12},
+        {'E', 'F', 1},
+        {'E', 'G', 5},
+        {'F', 'H', 8},
+        {'G', 'H', 3}
+    };
+}
+
+vector<CSRGraph<char>::Edge> graph2Edges() {
+    return {
+        {'A', 'B', 4},
+        {'A', 'C', 13},
+        {'A', 'D', 11},
+        {'B', 'C', 12},
+        {'B', 'E', 1},
+        {'C', 'D', 5},
+        {'C', 'E', 8},
+        {'D', 'E', 14},
+        {'E', 'F', 2},
+        {'E', 'G', 9},
+        {'F', 'G', 3},
+        {'G', 'H', 7},
+        {'H', 'I', 6},
+        {'H', 'J', 10},
+        {'I', 'J', 15},
+        {'J', 'K', 16},
+        {'K', 'L', 17}
+    };
+}
+
 Graph createGraph1() {
     Graph g;
-    g.addEdge('A', 'B', 6);
-    g.addEdge('A', 'D', 2);
-    g.addEdge('A', 'G', 4);
-    g.addEdge('B', 'E', 9);
-    g.addEdge('B', 'C', 13);
-    g.addEdge('C', 'F', 11);
-    g.addEdge('D', 'E', 14);
-    g.addEdge('D', 'G', 12);
-    g.addEdge('E', 'F', 1);
-    g.addEdge('E', 'G', 5);
-    g.addEdge('F', 'H', 8);
-    g.addEdge('G', 'H', 3);
-    return g;
+    for (const auto& e : graph1Edges()) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    return g;
+}
+
+Graph createGraph2() {
+    Graph g;
+    for (const auto& e : graph2Edges()) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    return g;
+}
+
+// ==================== 图文件读取 ====================
+// 边表：每行"起点 终点 [权重]"，以空白分隔，#或%开头的行是注释，缺省权重为1，多余的列忽略。
+// Matrix Market：%%MatrixMarket matrix coordinate {integer|real|pattern} {general|symmetric}，
+// 之后是注释、"行数 列数 非零元数"和每行"i j [值]"（下标从1开始，作为顶点ID原样保留）。
+// 文件先映射到内存，按换行切成若干块由线程池并行解析，各块的边按文件顺序拼接，
+// 因此结果与顺序解析完全相同。数字用手写的解析函数，不经过流和locale。
+
+inline void skipBlanks(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+}
+
+inline void skipLine(const char*& p, const char* end) {
+    const char* newline = (const char*)memchr(p, '\n', end - p);
+    p = newline ? newline + 1 : end;
+}
+
+// 数字之后必须是空白、行尾或文件尾，"3abc"这样的字段不接受
+inline bool atFieldEnd(const char* p, const char* end) {
+    return p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+}
+
+// 超出long long范围时返回false，不回绕
+inline bool parseInteger(const char*& p, const char* end, long long& value) {
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p == end || *p < '0' || *p > '9') return false;
+    unsigned long long limit = (unsigned long long)numeric_limits<long long>::max() + (negative ? 1 : 0);
+    unsigned long long v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        unsigned digit = *p - '0';
+        if (v > (limit - digit) / 10) return false;
+        v = v * 10 + digit;
+        p++;
+    }
+    value = negative ? (long long)(0 - v) : (long long)v;
+    return true;
+}
+
+// 十进制小数，可带指数
+inline bool parseNumber(const char*& p, const char* end, double& value) {
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    double v = 0;
+    bool digits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        p++;
+        digits = true;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            v += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+            digits = true;
+        }
+    }
+    if (!digits) return false;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        long long exponent;
+        if (!parseInteger(p, end, exponent)) return false;
+        v *= pow(10.0, (double)exponent);
+    }
+    value = negative ? -v : v;
+    return true;
+}
+
+// 权重检查的结果
+enum WeightError { WEIGHT_OK, WEIGHT_NOT_REPRESENTABLE, WEIGHT_NEGATIVE };
+
+// 整数权重的图不接受小数或超出范围的权重，避免悄悄舍入；
+// 负权重一律拒绝，Dijkstra、delta-stepping和DynamicGraph都要求权重非负
+template <typename Weight>
+WeightError toWeight(double value, Weight& weight) {
+    if (value < 0) return WEIGHT_NEGATIVE;
+    if constexpr (is_integral<Weight>::value) {
+        if (value != floor(value) || value > (double)numeric_limits<Weight>::max()) {
+            return WEIGHT_NOT_REPRESENTABLE;
+        }
+    }
+    weight = (Weight)value;
+    return WEIGHT_OK;
+}
+
+// 并行解析[begin, end)中的边行。withWeight为false时（pattern）不读第三列；
+// 出错时返回false，errorPos为出错行在文件中的字节偏移，weightError表示这一行格式正确但权重不能用
+template <typename Weight>
+bool parseEdgeLines(const char* begin, const char* end, bool withWeight, ThreadPool& pool,
+                    vector<typename CSRGraph<long long, Weight>::Edge>& edges, long long& errorPos,
+                    WeightError& weightError) {
+    typedef typename CSRGraph<long long, Weight>::Edge Edge;
+
+    // 每块至少1MB，边界移到下一行的开头
+    const long long MIN_CHUNK = 1 << 20;
+    long long length = end - begin;
+    int chunks = max(1LL, min((long long)pool.size() * 4, length / MIN_CHUNK));
+    vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = begin;
+    for (int c = 1; c < chunks; c++) {
+        const char* p = max(bounds[c - 1], begin + length * c / chunks);
+        if (p > begin && p[-1] != '\n') skipLine(p, end);
+        bounds[c] = p;
+    }
+
+    vector<vector<Edge>> parts(chunks);
+    vector<const char*> failures(chunks, nullptr);
+    vector<WeightError> weightFailures(chunks, WEIGHT_OK);
+    pool.parallelFor(chunks, [&](int c, int) {
+        const char* p = bounds[c];
+        const char* stop = bounds[c + 1];
+        vector<Edge>& out = parts[c];
+        out.reserve((stop - p) / 12);
+        while (p < stop) {
+            const char* line = p;
+            skipBlanks(p, stop);
+            if (p == stop || *p == '\n' || *p == '#' || *p == '%') {
+                skipLine(p, stop);
+                continue;
+            }
+
+            long long from = 0, to = 0;
+            double weight = 1;
+            bool ok = parseInteger(p, stop, from) && atFieldEnd(p, stop);
+            skipBlanks(p, stop);
+            ok = ok && parseInteger(p, stop, to) && atFieldEnd(p, stop);
+            skipBlanks(p, stop);
+            if (ok && withWeight && p < stop && *p != '\n') {
+                ok = parseNumber(p, stop, weight) && atFieldEnd(p, stop);
+            }
+            Weight value{};
+            if (ok) {
+                weightFailures[c] = toWeight(weight, value);
+                ok = weightFailures[c] == WEIGHT_OK;
+            }
+            if (!ok) {
+                failures[c] = line;
+                return;
+            }
+            out.push_back({from, to, value});
+            skipLine(p, stop);
+        }
+    });
+
+    for (int c = 0; c < chunks; c++) {
+        if (failures[c]) {
+            errorPos = failures[c] - begin;
+            weightError = weightFailures[c];
+            return false;
+        }
+    }
+
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    edges.clear();
+    edges.reserve(total);
+    for (auto& part : parts) {
+        edges.insert(edges.end(), part.begin(), part.end());
+        vector<Edge>().swap(part);
+    }
+    return true;
+}
+
+// 读取边表或Matrix Market文件。undirected返回建图方式：边表和symmetric的Matrix Market为true，
+// general的Matrix Market为false（有向）。vertexIds是文件声明的顶点：Matrix Market为1..max(行数, 列数)，
+// 建图时先登记，没有边的顶点也保留；边表为空
+template <typename Weight>
+bool readGraphText(const string& path, ThreadPool& pool, vector<typename CSRGraph<long long, Weight>::Edge>& edges,
+                   bool& undirected, vector<long long>& vertexIds) {
+    MappedFile file;
+    if (!file.open(path, true)) {
+        cerr << "Error: cannot read " << path << endl;
+        return false;
+    }
+    const char* begin = (const char*)file.data();
+    const char* end = begin + file.size();
+    const char* p = begin;
+    bool withWeight = true;
+    long long expected = -1;
+    long long rows = 0, cols = 0;
+    undirected = true;
+    vertexIds.clear();
+
+    const char* MM_BANNER = "%%MatrixMarket";
+    size_t bannerLength = strlen(MM_BANNER);
+    if (file.size() >= bannerLength && memcmp(begin, MM_BANNER, bannerLength) == 0) {
+        const char* lineEnd = p;
+        skipLine(lineEnd, end);
+        string banner(p, lineEnd);
+        transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+        if (banner.find("matrix") == string::npos || banner.find("coordinate") == string::npos ||
+            banner.find("complex") != string::npos || banner.find("hermitian") != string::npos ||
+            banner.find("skew-symmetric") != string::npos) {
+            cerr << "Error: " << path << ": only real/integer/pattern coordinate matrices (general or symmetric) are supported" << endl;
+            return false;
+        }
+        withWeight = banner.find("pattern") == string::npos;
+        undirected = banner.find("symmetric") != string::npos;
+
+        // 跳过注释，读"行数 列数 非零元数"
+        p = lineEnd;
+        while (p < end && *p == '%') skipLine(p, end);
+        skipBlanks(p, end);
+        bool ok = parseInteger(p, end, rows) && atFieldEnd(p, end);
+        skipBlanks(p, end);
+        ok = ok && parseInteger(p, end, cols) && atFieldEnd(p, end);
+        skipBlanks(p, end);
+        ok = ok && parseInteger(p, end, expected) && atFieldEnd(p, end);
+        ok = ok && rows >= 0 && cols >= 0 && expected >= 0 && max(rows, cols) < numeric_limits<int>::max();
+        if (!ok) {
+            cerr << "Error: " << path << ": bad Matrix Market size line" << endl;
+            return false;
+        }
+        skipLine(p, end);
+    }
+
+    long long errorPos;
+    WeightError weightError = WEIGHT_OK;
+    if (!parseEdgeLines<Weight>(p, end, withWeight, pool, edges, errorPos, weightError)) {
+        long long line = 1 + count(begin, p + errorPos, '\n');
+        if (weightError == WEIGHT_NEGATIVE) {
+            cerr << "Error: " << path << ":" << line << ": negative weight"
+                 << " (shortest-path algorithms require non-negative weights)" << endl;
+        } else if (weightError == WEIGHT_NOT_REPRESENTABLE) {
+            cerr << "Error: " << path << ":" << line << ": weight is not an integer in range"
+                 << " (only Matrix Market real files are loaded with floating-point weights)" << endl;
+        } else {
+            cerr << "Error: " << path << ":" << line << ": expected \"from to [weight]\"" << endl;
+        }
+        return false;
+    }
+
+    if (expected >= 0) {
+        if ((long long)edges.size() != expected) {
+            cerr << "Error: " << path << ": expected " << expected << " entries, found " << edges.size() << endl;
+            return false;
+        }
+        for (const auto& e : edges) {
+            if (e.from < 1 || e.from > rows || e.to < 1 || e.to > cols) {
+                cerr << "Error: " << path << ": entry (" << e.from << ", " << e.to << ") is out of range" << endl;
+                return false;
+            }
+        }
+        long long n = max(rows, cols);
+        vertexIds.resize(n);
+        for (long long i = 0; i < n; i++) vertexIds[i] = i + 1;
+    }
+    return true;
+}
+
+// 文件中的权重是否为浮点数：快照看文件头的标志，Matrix Market看real/double字段，边表总是整数
+bool hasRealWeights(const string& path) {
+    char head[sizeof(SnapshotHeader)] = {0};
+    ifstream probe(path.c_str(), ios::binary);
+    probe.read(head, sizeof(head));
+    if (memcmp(head, "CSRSNAP1", 8) == 0) {
+        SnapshotHeader header;
+        memcpy(&header, head, sizeof(header));
+        return (header.flags & SNAPSHOT_FLOAT_WEIGHTS) != 0;
+    }
+
+    string banner(head, strnlen(head, sizeof(head)));
+    banner = banner.substr(0, banner.find('\n'));
+    transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+    return banner.compare(0, 14, "%%matrixmarket") == 0 &&
+           (banner.find("real") != string::npos || banner.find("double") != string::npos);
+}
+
+// 按文件内容选择读取方式：CSR快照直接映射，其余按文本解析后建图
+template <typename Weight>
+bool loadGraph(const string& path, ThreadPool& pool, CSRGraph<long long, Weight>& graph) {
+    char magic[8] = {0};
+    ifstream probe(path.c_str(), ios::binary);
+    if (!probe) {
+        cerr << "Error: cannot read " << path << endl;
+        return false;
+    }
+    probe.read(magic, 8);
+    probe.close();
+    if (memcmp(magic, "CSRSNAP1", 8) == 0) {
+        return graph.loadSnapshot(path);
+    }
+
+    vector<typename CSRGraph<long long, Weight>::Edge> edges;
+    vector<long long> vertexIds;
+    bool undirected;
+    if (!readGraphText<Weight>(path, pool, edges, undirected, vertexIds)) return false;
+    graph.build(edges, undirected, vertexIds);
+    return true;
+}
+
+// ==================== 性能测试 ====================
+// 带--bench参数运行时执行，不带参数时只输出作业要求的结果
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// 大规模测试把顶点编号打散成64位ID，顺便测试哈希ID映射
+long long scatteredId(long long i) {
+    return (long long)((unsigned long long)(i + 1) * 0x9E3779B97F4A7C15ULL >> 1);
+}
+
+char charId(long long i) {
+    return (char)i;
+}
+
+int intId(long long i) {
+    return (int)i;
+}
+
+// n个顶点、m条边的随机简单无向图（无自环、无重边），权重在[1, maxWeight]内。
+// 前n-1条边是随机生成树，保证连通；label把顶点编号转换成顶点ID
+template <typename VertexId>
+vector<typename CSRGraph<VertexId>::Edge> makeRandomEdges(int n, long long m, int maxWeight, unsigned seed,
+                                                           VertexId (*label)(long long)) {
+    mt19937_64 rng(seed);
+    vector<typename CSRGraph<VertexId>::Edge> edges;
+    unordered_set<long long> used;
+    edges.reserve(m);
+    used.reserve(m);
+
+    auto tryAdd = [&](long long u, long long v) {
+        if (u == v) return;
+        long long key = min(u, v) * n + max(u, v);
+        if (!used.insert(key).second) return;
+        edges.push_back({label(u), label(v), (int)(rng() % maxWeight) + 1});
+    };
+
+    for (int i = 1; i < n && (long long)edges.size() < m; i++) {
+        tryAdd(rng() % i, i);
+    }
+    m = min(m, (long long)n * (n - 1) / 2);
+    while ((long long)edges.size() < m) {
+        tryAdd(rng() % n, rng() % n);
+    }
+    return edges;
+}
+
+// 幂律度分布的随机简单无向图：端点按u^3（u在[0,1)均匀）抽取，编号小的顶点度数高
+template <typename VertexId>
+vector<typename CSRGraph<VertexId>::Edge> makePowerLawEdges(int n, long long m, int maxWeight, unsigned seed,
+                                                             VertexId (*label)(long long)) {
+    mt19937_64 rng(seed);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    vector<typename CSRGraph<VertexId>::Edge> edges;
+    unordered_set<long long> used;
+    edges.reserve(m);
+    used.reserve(m);
+
+    long long attempts = 0;
+    while ((long long)edges.size() < m && attempts++ < m * 4) {
+        long long u = min((long long)(n * pow(uniform(rng), 3.0)), (long long)n - 1);
+        long long v = rng() % n;
+        if (u == v) continue;
+        long long key = min(u, v) * n + max(u, v);
+        if (!used.insert(key).second) continue;
+        edges.push_back({label(u), label(v), (int)(rng() % maxWeight) + 1});
+    }
+    return edges;
+}
+
+// side×side的四邻接网格，直径约2*side，是delta-stepping最不利的情形
+template <typename VertexId>
+vector<typename CSRGraph<VertexId>::Edge> makeGridEdges(int side, int maxWeight, unsigned seed,
+                                                         VertexId (*label)(long long)) {
+    mt19937_64 rng(seed);
+    vector<typename CSRGraph<VertexId>::Edge> edges;
+    edges.reserve((long long)side * side * 2);
+    for (long long r = 0; r < side; r++) {
+        for (long long c = 0; c < side; c++) {
+            long long v = r * side + c;
+            if (c + 1 < side) edges.push_back({label(v), label(v + 1), (int)(rng() % maxWeight) + 1});
+            if (r + 1 < side) edges.push_back({label(v), label(v + side), (int)(rng() % maxWeight) + 1});
+        }
+    }
+    return edges;
+}
+
+template <typename T>
+void printCheck(const string& name, const T& expected, const T& actual) {
+    cout << "  " << name << ": " << (expected == actual ? "一致" : "不一致！") << endl;
+}
+
+// CSRGraph先在作业图和小随机图上与Graph逐项对比，再在大规模随机图上计时
+void benchCSR(int vertices) {
+    cout << "=== CSR图与邻接矩阵图对比 ===" << endl;
+    for (int k = 1; k <= 2; k++) {
+        Graph g = k == 1 ? createGraph1() : createGraph2();
+        CSRGraph<char> csr(k == 1 ? graph1Edges() : graph2Edges());
+        cout << "图" << k << ":" << endl;
+        printCheck("BFS", g.BFS('A'), csr.BFS('A'));
+        printCheck("DFS", g.DFS('A'), csr.DFS('A'));
+        printCheck("最短路径", g.shortestPath('A'), csr.shortestPath('A'));
+        printCheck("最小生成树", g.primMST('A'), csr.primMST('A'));
+        printCheck("双连通分量和关节点", g.findBCCAndArticulationPoints(), csr.findBCCAndArticulationPoints());
+    }
+
+    // Graph以char为顶点，最多只能容纳256个顶点
+    int small = 250;
+    vector<CSRGraph<char>::Edge> smallEdges = makeRandomEdges<char>(small, small * 4, 100, 1, charId);
+    Graph g;
+    for (const auto& e : smallEdges) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    CSRGraph<char> csr(smallEdges);
+    char start = smallEdges[0].from;
+    cout << small << "个顶点的随机图:" << endl;
+    printCheck("BFS", g.BFS(start), csr.BFS(start));
+    printCheck("DFS", g.DFS(start), csr.DFS(start));
+    printCheck("最短路径", g.shortestPath(start), csr.shortestPath(start));
+    printCheck("最小生成树", g.primMST(start), csr.primMST(start));
+    printCheck("双连通分量和关节点", g.findBCCAndArticulationPoints(), csr.findBCCAndArticulationPoints());
+
+    auto t = chrono::steady_clock::now();
+    g.shortestPath(start);
+    double matrixPath = elapsedMs(t);
+    t = chrono::steady_clock::now();
+    csr.shortestPath(start);
+    double csrPath = elapsedMs(t);
+    t = chrono::steady_clock::now();
+    g.primMST(start);
+    double matrixPrim = elapsedMs(t);
+    t = chrono::steady_clock::now();
+    csr.primMST(start);
+    double csrPrim = elapsedMs(t);
+    cout << fixed << setprecision(3);
+    cout << "  最短路径: 邻接矩阵 " << matrixPath << " ms, CSR " << csrPath << " ms" << endl;
+    cout << "  最小生成树: 邻接矩阵 " << matrixPrim << " ms, CSR " << csrPrim << " ms" << endl;
+    cout << endl;
+
+    cout << "=== 大规模CSR图 ===" << endl;
+    long long edgeCount = (long long)vertices * 4;
+    t = chrono::steady_clock::now();
+    vector<CSRGraph<long long>::Edge> edges = makeRandomEdges<long long>(vertices, edgeCount, 1000, 2, scatteredId);
+    cout << vertices << "个顶点, " << edges.size() << "条边, 生成边表 " << elapsedMs(t) << " ms" << endl;
+
+    t = chrono::steady_clock::now();
+    CSRGraph<long long> big(edges);
+    cout << "  构建CSR: " << elapsedMs(t) << " ms, 邻接数组 "
+         << (big.arcCount() * (sizeof(int) + sizeof(int)) + (big.vertexCount() + 1) * sizeof(long long)) / (1024.0 * 1024.0)
+         << " MB（邻接矩阵需要 " << (double)vertices * vertices * sizeof(int) / (1024.0 * 1024.0 * 1024.0) << " GB）" << endl;
+
+    long long source = edges[0].from;
+    t = chrono::steady_clock::now();
+    size_t reached = big.BFS(source).size();
+    cout << "  BFS: " << elapsedMs(t) << " ms, 到达" << reached << "个顶点" << endl;
+    t = chrono::steady_clock::now();
+    reached = big.DFS(source).size();
+    cout << "  DFS: " << elapsedMs(t) << " ms, 到达" << reached << "个顶点" << endl;
+    t = chrono::steady_clock::now();
+    auto dist = big.shortestPath(source);
+    cout << "  最短路径: " << elapsedMs(t) << " ms" << endl;
+    t = chrono::steady_clock::now();
+    size_t treeEdges = big.primMST(source).size();
+    cout << "  最小生成树: " << elapsedMs(t) << " ms, " << treeEdges << "条边" << endl;
+    t = chrono::steady_clock::now();
+    auto bcc = big.findBCCAndArticulationPoints();
+    cout << "  双连通分量: " << elapsedMs(t) << " ms, " << bcc.first.size() << "个分量, "
+         << bcc.second.size() << "个关节点" << endl;
+    cout << endl;
 }
 
-Graph createGraph2() {
+// 每个顶点的前驱都应满足dist[pred] + w(pred, v) == dist[v]
+template <typename VertexId>
+bool checkPredecessors(const CSRGraph<VertexId>& g, const typename CSRGraph<VertexId>::ShortestPaths& paths) {
+    for (int v = 0; v < g.vertexCount(); v++) {
+        int p = paths.pred[v];
+        if (p == -1) continue;
+        bool found = false;
+        for (long long e = g.edgeBegin(p); e < g.edgeEnd(p) && !found; e++) {
+            found = g.target(e) == v && paths.dist[p] + g.weight(e) == paths.dist[v];
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// 索引d叉堆Dijkstra与原有的O(V^2)实现、priority_queue实现对比，并测试提前终止
+void benchDijkstra(int vertices) {
+    cout << "=== 索引堆Dijkstra ===" << endl;
+    cout << fixed << setprecision(3);
+
+    CSRGraph<char> g1(graph1Edges());
+    int length;
+    vector<char> path = g1.findPath('A', 'C', length);
+    cout << "图1中A到C的最短路径（长度" << length << "）: ";
+    for (char c : path) {
+        cout << c << " ";
+    }
+    cout << endl;
+
+    int small = 250;
+    vector<CSRGraph<char>::Edge> smallEdges = makeRandomEdges<char>(small, small * 4, 100, 1, charId);
     Graph g;
-    g.addEdge('A', 'B', 4);
-    g.addEdge('A', 'C', 13);
-    g.addEdge('A', 'D', 11);
-    g.addEdge('B', 'C', 12);
-    g.addEdge('B', 'E', 1);
-    g.addEdge('C', 'D', 5);
-    g.addEdge('C', 'E', 8);
-    g.addEdge('D', 'E', 14);
-    g.addEdge('E', 'F', 2);
-    g.addEdge('E', 'G', 9);
-    g.addEdge('F', 'G', 3);
-    g.addEdge('G', 'H', 7);
-    g.addEdge('H', 'I', 6);
-    g.addEdge('H', 'J', 10);
-    g.addEdge('I', 'J', 15);
-    g.addEdge('J', 'K', 16);
-    g.addEdge('K', 'L', 17);
-    return g;
+    for (const auto& e : smallEdges) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    CSRGraph<char> csr(smallEdges);
+    char start = smallEdges[0].from;
+    auto expected = g.shortestPath(start);
+    auto paths = csr.dijkstra(csr.indexOf(start));
+    bool same = true;
+    for (const auto& item : expected) {
+        same = same && paths.dist[csr.indexOf(item.first)] == item.second;
+    }
+    cout << small << "个顶点的随机图: 距离与Graph::shortestPath" << (same ? "一致" : "不一致！")
+         << ", 前驱" << (checkPredecessors(csr, paths) ? "正确" : "错误！") << endl;
+
+    const int rounds = 100;
+    auto t = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) g.shortestPath(start);
+    double matrixTime = elapsedMs(t) / rounds;
+    t = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) csr.dijkstra(csr.indexOf(start));
+    double heapTime = elapsedMs(t) / rounds;
+    cout << "  邻接矩阵O(V^2): " << matrixTime << " ms, 索引4叉堆: " << heapTime << " ms" << endl;
+
+    long long edgeCount = (long long)vertices * 4;
+    CSRGraph<long long> big(makeRandomEdges<long long>(vertices, edgeCount, 1000, 2, scatteredId));
+    cout << vertices << "个顶点, " << edgeCount << "条边:" << endl;
+
+    int source = 0;
+    t = chrono::steady_clock::now();
+    auto lazy = big.shortestPath(big.vertexAt(source));
+    cout << "  priority_queue（重复入堆）: " << elapsedMs(t) << " ms" << endl;
+
+    t = chrono::steady_clock::now();
+    auto binary = big.dijkstra<2>(source);
+    double binaryTime = elapsedMs(t);
+    t = chrono::steady_clock::now();
+    auto quad = big.dijkstra<4>(source);
+    double quadTime = elapsedMs(t);
+    t = chrono::steady_clock::now();
+    auto oct = big.dijkstra<8>(source);
+    double octTime = elapsedMs(t);
+
+    same = binary.dist == quad.dist && quad.dist == oct.dist;
+    for (int v = 0; v < big.vertexCount() && same; v++) {
+        same = lazy[v].second == quad.dist[v];
+    }
+    cout << "  索引2叉堆: " << binaryTime << " ms, 4叉堆: " << quadTime << " ms, 8叉堆: " << octTime << " ms" << endl;
+    cout << "  距离" << (same ? "一致" : "不一致！") << ", 前驱" << (checkPredecessors(big, quad) ? "正确" : "错误！") << endl;
+
+    // 点到点查询：目标出堆即停止，平均只需扫描一部分图
+    mt19937 rng(3);
+    const int queries = 20;
+    double earlyTime = 0;
+    bool earlySame = true;
+    for (int q = 0; q < queries; q++) {
+        int target = rng() % big.vertexCount();
+        t = chrono::steady_clock::now();
+        auto partial = big.dijkstra(source, target);
+        earlyTime += elapsedMs(t);
+        earlySame = earlySame && partial.dist[target] == quad.dist[target] &&
+                    big.pathTo(partial, target).size() == big.pathTo(quad, target).size();
+    }
+    cout << "  点到点查询（提前终止）: 平均 " << earlyTime / queries << " ms, 结果"
+         << (earlySame ? "一致" : "不一致！") << endl;
+    cout << endl;
+}
+
+// delta-stepping在幂律图和网格图上的线程扩展性，距离与shortestPath逐一比较
+void benchDeltaStepping(int vertices, int maxThreads, int delta) {
+    cout << "=== 并行delta-stepping ===" << endl;
+    cout << fixed << setprecision(3);
+
+    int side = max(2, (int)sqrt((double)vertices));
+    for (int k = 0; k < 2; k++) {
+        CSRGraph<long long> g(k == 0 ? makePowerLawEdges<long long>(vertices, (long long)vertices * 4, 1000, 4, scatteredId)
+                                     : makeGridEdges<long long>(side, 1000, 5, scatteredId));
+        long long start = g.vertexAt(0);
+        int graphDelta = delta > 0 ? delta : g.defaultDelta();
+        cout << (k == 0 ? "幂律图" : "网格图") << ": " << g.vertexCount() << "个顶点, " << g.arcCount() / 2
+             << "条边, delta=" << graphDelta << endl;
+
+        auto t = chrono::steady_clock::now();
+        auto expected = g.shortestPath(start);
+        cout << "  Dijkstra（priority_queue）: " << elapsedMs(t) << " ms" << endl;
+
+        double oneThread = 0;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            ThreadPool pool(threads);
+            t = chrono::steady_clock::now();
+            vector<int> dist = g.deltaStepping(start, graphDelta, pool);
+            double elapsed = elapsedMs(t);
+            if (threads == 1) oneThread = elapsed;
+
+            bool same = true;
+            for (int v = 0; v < g.vertexCount() && same; v++) {
+                same = dist[v] == expected[v].second;
+            }
+            cout << "  " << setw(2) << threads << "线程: " << elapsed << " ms, 加速比 " << setprecision(2)
+                 << oneThread / max(elapsed, 1e-6) << "x" << setprecision(3) << (same ? "" : "（距离不一致！）") << endl;
+        }
+
+        // delta对轮数和重复松弛的影响
+        ThreadPool pool(maxThreads);
+        cout << "  " << maxThreads << "线程下不同delta:";
+        bool allSame = true;
+        for (int scale : {1, 4, 16, 64}) {
+            int d = max(1, graphDelta * scale / 4);
+            t = chrono::steady_clock::now();
+            vector<int> dist = g.deltaStepping(start, d, pool);
+            cout << " delta=" << d << " " << elapsedMs(t) << " ms";
+            for (int v = 0; v < g.vertexCount() && allSame; v++) {
+                allSame = dist[v] == expected[v].second;
+            }
+        }
+        cout << (allSame ? "" : "（距离不一致！）") << endl;
+    }
+
+    // 权重很大而delta=1：桶的编号可达上亿，循环桶加溢出表的内存只与顶点数有关
+    int small = max(2, vertices / 50);
+    CSRGraph<long long> heavy(makeRandomEdges<long long>(small, (long long)small * 4, 10000000, 6, scatteredId));
+    long long start = heavy.vertexAt(0);
+    auto expected = heavy.shortestPath(start);
+    ThreadPool pool(maxThreads);
+    auto t = chrono::steady_clock::now();
+    vector<int> dist = heavy.deltaStepping(start, 1, pool);
+    bool same = true;
+    for (int v = 0; v < heavy.vertexCount() && same; v++) {
+        same = dist[v] == expected[v].second;
+    }
+    cout << small << "个顶点、权重至1e7的随机图, delta=1: " << elapsedMs(t) << " ms, 距离" << (same ? "一致" : "不一致！")
+         << endl;
+    cout << endl;
 }
 
-int main() {
+// 顺序BFS求各顶点层数，用来检查并行BFS
+template <typename VertexId>
+vector<int> bfsDepths(const CSRGraph<VertexId>& g, int source) {
+    vector<int> depth(g.vertexCount(), -1);
+    vector<int> q(1, source);
+    depth[source] = 0;
+    for (size_t head = 0; head < q.size(); head++) {
+        int u = q[head];
+        for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            int v = g.target(e);
+            if (depth[v] == -1) {
+                depth[v] = depth[u] + 1;
+                q.push_back(v);
+            }
+        }
+    }
+    return depth;
+}
+
+// 层数与顺序BFS相同，且每个顶点的parent是上一层的邻居
+template <typename VertexId>
+bool checkBFSTree(const CSRGraph<VertexId>& g, const typename CSRGraph<VertexId>::BFSTree& tree,
+                  const vector<int>& expectedDepth) {
+    if (tree.depth != expectedDepth) return false;
+    for (int v = 0; v < g.vertexCount(); v++) {
+        int p = tree.parent[v];
+        if (tree.depth[v] <= 0) continue;
+        if (p < 0 || tree.depth[p] != tree.depth[v] - 1) return false;
+        bool adjacent = false;
+        for (long long e = g.edgeBegin(v); e < g.edgeEnd(v) && !adjacent; e++) {
+            adjacent = g.target(e) == p;
+        }
+        if (!adjacent) return false;
+    }
+    return true;
+}
+
+// 方向优化BFS与纯自顶向下BFS比较时间和边检查次数
+void benchParallelBFS(int vertices, int maxThreads) {
+    cout << "=== 方向优化并行BFS ===" << endl;
+    cout << fixed << setprecision(3);
+
+    int side = max(2, (int)sqrt((double)vertices));
+    const char* names[] = {"随机图", "幂律图", "网格图"};
+    for (int k = 0; k < 3; k++) {
+        CSRGraph<long long> g(k == 0 ? makeRandomEdges<long long>(vertices, (long long)vertices * 8, 1000, 6, scatteredId)
+                              : k == 1 ? makePowerLawEdges<long long>(vertices, (long long)vertices * 8, 1000, 7, scatteredId)
+                                       : makeGridEdges<long long>(side, 1000, 8, scatteredId));
+        long long start = g.vertexAt(0);
+        cout << names[k] << ": " << g.vertexCount() << "个顶点, " << g.arcCount() / 2 << "条边" << endl;
+
+        auto t = chrono::steady_clock::now();
+        g.BFS(start);
+        cout << "  顺序BFS（队列）: " << elapsedMs(t) << " ms" << endl;
+        vector<int> expected = bfsDepths(g, 0);
+
+        for (int threads : {1, maxThreads}) {
+            ThreadPool pool(threads);
+            for (int optimized = 0; optimized < 2; optimized++) {
+                t = chrono::steady_clock::now();
+                auto tree = g.parallelBFS(start, pool, optimized == 1);
+                double elapsed = elapsedMs(t);
+                cout << "  " << (optimized ? "方向优化" : "自顶向下") << " " << threads << "线程: " << elapsed
+                     << " ms, 检查" << tree.edgesExamined << "条边, " << tree.levels << "层（自底向上"
+                     << tree.bottomUpLevels << "层）" << (checkBFSTree(g, tree, expected) ? "" : "（结果错误！）") << endl;
+            }
+            if (threads == maxThreads) break;
+        }
+    }
+    cout << endl;
+}
+
+// 删除每条边后检查两端是否仍连通，暴力求桥，用来检查findBridges
+template <typename VertexId>
+set<pair<int, int>> bruteForceBridges(const CSRGraph<VertexId>& g) {
+    set<pair<int, int>> bridges;
+    int n = g.vertexCount();
+    for (int a = 0; a < n; a++) {
+        for (long long removed = g.edgeBegin(a); removed < g.edgeEnd(a); removed++) {
+            int b = g.target(removed);
+            if (a >= b) continue;
+
+            // 从a出发BFS，不走被删除的这一条弧及其反向弧
+            vector<bool> seen(n, false);
+            vector<int> q(1, a);
+            seen[a] = true;
+            bool skippedReverse = false;
+            for (size_t head = 0; head < q.size() && !seen[b]; head++) {
+                int u = q[head];
+                for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+                    if (e == removed) continue;
+                    if (u == b && g.target(e) == a && !skippedReverse) {
+                        skippedReverse = true;
+                        continue;
+                    }
+                    int v = g.target(e);
+                    if (!seen[v]) {
+                        seen[v] = true;
+                        q.push_back(v);
+                    }
+                }
+            }
+            if (!seen[b]) bridges.insert({a, b});
+        }
+    }
+    return bridges;
+}
+
+// 深图上的迭代DFS和双连通分量：路径图的DFS栈深度等于顶点数，递归版会栈溢出
+void benchDeepGraphs(int vertices) {
+    cout << "=== 深图上的迭代DFS与双连通分量 ===" << endl;
+    cout << fixed << setprecision(3);
+
+    // 稀疏随机图（含重边）上用暴力法检查桥
+    int small = 300;
+    vector<CSRGraph<int>::Edge> sparse = makeRandomEdges<int>(small, small + 60, 10, 9, intId);
+    sparse.push_back(sparse[0]);
+    CSRGraph<int> sparseGraph(sparse);
+    set<pair<int, int>> expected = bruteForceBridges(sparseGraph);
+    set<pair<int, int>> found;
+    for (const auto& edge : sparseGraph.findBridges()) {
+        int a = sparseGraph.indexOf(edge.first), b = sparseGraph.indexOf(edge.second);
+        found.insert({min(a, b), max(a, b)});
+    }
+    cout << small << "个顶点的稀疏图: " << found.size() << "座桥，与暴力法"
+         << (found == expected ? "一致" : "不一致！") << endl;
+
+    // 路径图：n-1个分量、n-2个关节点、n-1座桥；三角形链：k个分量、k-1个关节点、没有桥
+    for (int k = 0; k < 2; k++) {
+        vector<CSRGraph<int>::Edge> edges;
+        if (k == 0) {
+            for (int i = 0; i + 1 < vertices; i++) {
+                edges.push_back({i, i + 1, 1});
+            }
+        } else {
+            for (int i = 0; i + 2 < vertices; i += 2) {
+                edges.push_back({i, i + 1, 1});
+                edges.push_back({i + 1, i + 2, 1});
+                edges.push_back({i, i + 2, 1});
+            }
+        }
+        CSRGraph<int> g(edges);
+        int n = g.vertexCount();
+        long long expectedComponents = k == 0 ? n - 1 : (n - 1) / 2;
+        long long expectedArticulation = k == 0 ? n - 2 : (n - 1) / 2 - 1;
+        long long expectedBridges = k == 0 ? n - 1 : 0;
+        cout << (k == 0 ? "路径图" : "三角形链") << ": " << n << "个顶点, " << g.arcCount() / 2 << "条边" << endl;
+
+        auto t = chrono::steady_clock::now();
+        size_t visited = g.DFS(0).size();
+        cout << "  DFS: " << elapsedMs(t) << " ms, 访问" << visited << "个顶点" << endl;
+
+        long long components = 0, largest = 0;
+        vector<bool> articulation;
+        vector<pair<int, int>> bridges;
+        t = chrono::steady_clock::now();
+        g.biconnectedComponents([&](const pair<int, int>*, size_t count) {
+            components++;
+            largest = max(largest, (long long)count);
+        }, &articulation, &bridges);
+        double elapsed = elapsedMs(t);
+        long long articulationCount = count(articulation.begin(), articulation.end(), true);
+        bool correct = components == expectedComponents && articulationCount == expectedArticulation &&
+                       (long long)bridges.size() == expectedBridges;
+        cout << "  双连通分量（回调）: " << elapsed << " ms, " << components << "个分量（最大" << largest << "条边）, "
+             << articulationCount << "个关节点, " << bridges.size() << "座桥" << (correct ? "" : "（结果错误！）") << endl;
+
+        // 保存全部分量时每个分量都是一个vector，规模很大时内存占用远超图本身
+        if (n <= 2000000) {
+            t = chrono::steady_clock::now();
+            auto bcc = g.findBCCAndArticulationPoints();
+            cout << "  双连通分量（保存全部分量）: " << elapsedMs(t) << " ms" << endl;
+        }
+    }
+    cout << endl;
+}
+
+// primMST只返回边的两个端点，取两端点间最轻的边求总权重
+template <typename VertexId>
+long long treeWeight(const CSRGraph<VertexId>& g, const vector<pair<VertexId, VertexId>>& tree) {
+    long long total = 0;
+    for (const auto& edge : tree) {
+        int u = g.indexOf(edge.first), v = g.indexOf(edge.second);
+        int lightest = CSRGraph<VertexId>::infinity();
+        for (long long e = g.edgeBegin(u); e < g.edgeEnd(u); e++) {
+            if (g.target(e) == v) lightest = min(lightest, g.weight(e));
+        }
+        total += lightest;
+    }
+    return total;
+}
+
+// Kruskal和并行Borůvka与primMST比较总权重和时间，包括0权重边和不连通的图
+void benchMST(int vertices, int maxThreads) {
+    cout << "=== Kruskal与并行Borůvka最小生成树 ===" << endl;
+    cout << fixed << setprecision(3);
+    ThreadPool pool(maxThreads);
+
+    // 图1加一条0权重边；再加上用小写字母表示的图2，成为两个连通分量
+    vector<CSRGraph<char>::Edge> edges = graph1Edges();
+    edges.push_back({'C', 'H', 0});
+    Graph g;
+    for (const auto& e : edges) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    CSRGraph<char> withZero(edges);
+    cout << "图1加0权重边C-H: Graph::primMST总权重 " << treeWeight(withZero, g.primMST('A'))
+         << "（0权重边被当作没有边）, Kruskal " << withZero.kruskalMST().totalWeight << ", Borůvka "
+         << withZero.boruvkaMST(pool).totalWeight << endl;
+
+    for (const auto& e : graph2Edges()) {
+        edges.push_back({(char)(e.from - 'A' + 'a'), (char)(e.to - 'A' + 'a'), e.weight});
+    }
+    CSRGraph<char> forestGraph(edges);
+    auto kruskal = forestGraph.kruskalMST();
+    auto boruvka = forestGraph.boruvkaMST(pool);
+    cout << "再加上图2: Kruskal总权重 " << kruskal.totalWeight << ", " << kruskal.trees << "棵树, "
+         << kruskal.edges.size() << "条边; Borůvka总权重 " << boruvka.totalWeight << ", " << boruvka.trees
+         << "棵树; CSR primMST总权重 " << treeWeight(forestGraph, forestGraph.primMST('A')) << endl;
+
+    int small = 250;
+    vector<CSRGraph<char>::Edge> smallEdges = makeRandomEdges<char>(small, small * 4, 100, 1, charId);
+    Graph smallGraph;
+    for (const auto& e : smallEdges) {
+        smallGraph.addEdge(e.from, e.to, e.weight);
+    }
+    CSRGraph<char> smallCsr(smallEdges);
+    char start = smallEdges[0].from;
+    const int rounds = 100;
+    auto t = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) smallGraph.primMST(start);
+    double primTime = elapsedMs(t) / rounds;
+    t = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) smallCsr.kruskalMST();
+    double kruskalTime = elapsedMs(t) / rounds;
+    long long primWeight = treeWeight(smallCsr, smallGraph.primMST(start));
+    cout << small << "个顶点的随机图: Graph::primMST " << primTime << " ms, Kruskal " << kruskalTime
+         << " ms, 总权重" << (primWeight == smallCsr.kruskalMST().totalWeight ? "一致" : "不一致！") << endl;
+
+    // 有向输入（例如general的Matrix Market）：每条弧当作无向边，Borůvka要与Kruskal一致
+    CSRGraph<int> directed({{0, 1, 10}, {2, 0, 1}, {1, 2, 2}}, false);
+    vector<CSRGraph<int>::Edge> randomArcs = makeRandomEdges<int>(small, small * 4, 10, 11, intId);
+    for (int i = 0; i < small; i++) {
+        randomArcs.push_back({randomArcs[i].to, randomArcs[i].from, randomArcs[i].weight + 1});
+    }
+    CSRGraph<int> directedRandom(randomArcs, false);
+    cout << "有向图{0->1 10, 2->0 1, 1->2 2}: Kruskal总权重 " << directed.kruskalMST().totalWeight << ", Borůvka "
+         << directed.boruvkaMST(pool).totalWeight << "; " << small << "个顶点的随机有向图: 总权重"
+         << (directedRandom.kruskalMST().totalWeight == directedRandom.boruvkaMST(pool).totalWeight ? "一致" : "不一致！")
+         << endl;
+
+    CSRGraph<long long> big(makeRandomEdges<long long>(vertices, (long long)vertices * 4, 1000, 10, scatteredId));
+    cout << big.vertexCount() << "个顶点, " << big.arcCount() / 2 << "条边:" << endl;
+    t = chrono::steady_clock::now();
+    auto primTree = big.primMST(big.vertexAt(0));
+    cout << "  CSR primMST（二叉堆）: " << elapsedMs(t) << " ms" << endl;
+    long long expected = treeWeight(big, primTree);
+
+    t = chrono::steady_clock::now();
+    auto bigKruskal = big.kruskalMST();
+    cout << "  Kruskal: " << elapsedMs(t) << " ms, 总权重" << (bigKruskal.totalWeight == expected ? "一致" : "不一致！")
+         << endl;
+
+    double oneThread = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool threadPool(threads);
+        t = chrono::steady_clock::now();
+        auto forest = big.boruvkaMST(threadPool);
+        double elapsed = elapsedMs(t);
+        if (threads == 1) oneThread = elapsed;
+        cout << "  Borůvka " << setw(2) << threads << "线程: " << elapsed << " ms, 加速比 " << setprecision(2)
+             << oneThread / max(elapsed, 1e-6) << "x" << setprecision(3)
+             << (forest.totalWeight == expected && forest.edges.size() == primTree.size() ? "" : "（结果错误！）") << endl;
+    }
+    cout << endl;
+}
+
+// 把边表写成文本文件，matrixMarket为true时写成symmetric的Matrix Market（下标加1）
+bool writeEdgeText(const string& path, const vector<CSRGraph<long long>::Edge>& edges, long long n, bool matrixMarket) {
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) {
+        cerr << "Error: cannot write " << path << endl;
+        return false;
+    }
+    static char buffer[1 << 20];
+    setvbuf(out, buffer, _IOFBF, sizeof(buffer));
+    long long base = 0;
+    if (matrixMarket) {
+        fprintf(out, "%%%%MatrixMarket matrix coordinate integer symmetric\n%% generated by exp3\n");
+        fprintf(out, "%lld %lld %zu\n", n, n, edges.size());
+        base = 1;
+    } else {
+        fprintf(out, "# from to weight\n");
+    }
+    for (const auto& e : edges) {
+        fprintf(out, "%lld %lld %d\n", e.from + base, e.to + base, e.weight);
+    }
+    bool ok = ferror(out) == 0;
+    ok = fclose(out) == 0 && ok;
+    if (!ok) cerr << "Error: failed writing " << path << endl;
+    return ok;
+}
+
+long long fileSize(const string& path) {
+    ifstream in(path.c_str(), ios::binary | ios::ate);
+    return in ? (long long)in.tellg() : -1;
+}
+
+// 边表/Matrix Market的顺序与并行解析，以及CSR快照的写入和映射读取。临时文件写在当前目录，结束后删除
+void benchLoader(int vertices, int maxThreads) {
+    cout << "=== 图文件读取 ===" << endl;
+    cout << fixed << setprecision(3);
+
+    // 顶点ID就是0..n-1，文本文件按编号顺序比较解析结果
+    vector<CSRGraph<long long>::Edge> edges =
+        makeRandomEdges<long long>(vertices, (long long)vertices * 4, 1000, 11, [](long long i) { return i; });
+    CSRGraph<long long> reference(edges);
+    const string textPath = "exp3_bench_edges.txt";
+    const string mtxPath = "exp3_bench_edges.mtx";
+    const string snapshotPath = "exp3_bench_graph.csr";
+    if (!writeEdgeText(textPath, edges, vertices, false) || !writeEdgeText(mtxPath, edges, vertices, true)) return;
+    cout << vertices << "个顶点, " << edges.size() << "条边; 边表 " << fileSize(textPath) / (1024.0 * 1024.0)
+         << " MB, Matrix Market " << fileSize(mtxPath) / (1024.0 * 1024.0) << " MB" << endl;
+
+    auto sameGraph = [&](const CSRGraph<long long>& g) {
+        if (g.vertexCount() != reference.vertexCount() || g.arcCount() != reference.arcCount()) return false;
+        for (int u = 0; u < g.vertexCount(); u++) {
+            if (g.vertexAt(u) != reference.vertexAt(u) || g.edgeBegin(u) != reference.edgeBegin(u)) return false;
+        }
+        for (long long e = 0; e < g.arcCount(); e++) {
+            if (g.target(e) != reference.target(e) || g.weight(e) != reference.weight(e)) return false;
+        }
+        return true;
+    };
+    // 按ID比较邻居和权重（顶点编号顺序可以不同）
+    auto sameById = [](const CSRGraph<long long>& g, const CSRGraph<long long>& expected) {
+        if (g.vertexCount() != expected.vertexCount() || g.arcCount() != expected.arcCount()) return false;
+        for (int u = 0; u < g.vertexCount(); u++) {
+            long long id = g.vertexAt(u);
+            int r = expected.indexOf(id);
+            if (r == -1 || g.indexOf(id) != u || g.degree(u) != expected.degree(r)) return false;
+            for (long long i = 0; i < g.degree(u); i++) {
+                long long e = g.edgeBegin(u) + i, f = expected.edgeBegin(r) + i;
+                if (g.vertexAt(g.target(e)) != expected.vertexAt(expected.target(f)) || g.weight(e) != expected.weight(f)) {
+                    return false;
+                }
+            }
+        }
+        return g.indexOf(-1) == -1 && g.BFS(expected.vertexAt(0)) == expected.BFS(expected.vertexAt(0));
+    };
+
+    // Matrix Market的ID从1开始，先按1..n登记顶点
+    vector<CSRGraph<long long>::Edge> shifted = edges;
+    vector<long long> mmIds(vertices);
+    for (auto& e : shifted) {
+        e.from++;
+        e.to++;
+    }
+    for (int i = 0; i < vertices; i++) mmIds[i] = i + 1;
+    CSRGraph<long long> mmReference;
+    mmReference.build(shifted, true, mmIds);
+
+    for (int k = 0; k < 2; k++) {
+        const string& path = k == 0 ? textPath : mtxPath;
+        for (int threads : {1, maxThreads}) {
+            ThreadPool pool(threads);
+            vector<CSRGraph<long long>::Edge> parsed;
+            vector<long long> ids;
+            bool undirected;
+            auto t = chrono::steady_clock::now();
+            if (!readGraphText<int>(path, pool, parsed, undirected, ids)) return;
+            double parseTime = elapsedMs(t);
+            t = chrono::steady_clock::now();
+            CSRGraph<long long> g;
+            g.build(parsed, undirected, ids);
+            double buildTime = elapsedMs(t);
+            bool same = k == 0 ? sameGraph(g) : sameById(g, mmReference);
+            cout << "  " << (k == 0 ? "边表" : "Matrix Market") << " " << threads << "线程: 解析 " << parseTime
+                 << " ms, 建图 " << buildTime << " ms" << (same ? "" : "（结果不一致！）") << endl;
+            if (threads == maxThreads) break;
+        }
+    }
+
+    // 快照按ID重新编号后写入：第一张图的ID是连续的1..n但首次出现的顺序相反（编号直接相减），
+    // 第二张图的ID是打散的64位整数（二分查找）
+    for (int k = 0; k < 2; k++) {
+        vector<CSRGraph<long long>::Edge> renamed = edges;
+        for (auto& e : renamed) {
+            e.from = k == 0 ? vertices - e.from : scatteredId(e.from);
+            e.to = k == 0 ? vertices - e.to : scatteredId(e.to);
+        }
+        CSRGraph<long long> source(renamed);
+        auto t = chrono::steady_clock::now();
+        if (!source.writeSnapshot(snapshotPath)) return;
+        cout << "  " << (k == 0 ? "连续ID" : "打散ID") << " 写快照: " << elapsedMs(t) << " ms, "
+             << fileSize(snapshotPath) / (1024.0 * 1024.0) << " MB";
+
+        t = chrono::steady_clock::now();
+        CSRGraph<long long> mapped;
+        if (!mapped.loadSnapshot(snapshotPath)) return;
+        double mapTime = elapsedMs(t);
+        t = chrono::steady_clock::now();
+        bool same = sameById(mapped, source);
+        cout << ", 映射并检查: " << mapTime << " ms（按ID遍历全图并比较 " << elapsedMs(t) << " ms）"
+             << (same ? "" : "（结果不一致！）") << endl;
+    }
+
+    // 损坏的快照：把一条弧的终点改成越界的编号
+    {
+        fstream corrupt(snapshotPath.c_str(), ios::in | ios::out | ios::binary);
+        SnapshotHeader header;
+        corrupt.read((char*)&header, sizeof(header));
+        int bad = vertices;
+        corrupt.seekp(header.targetsPos);
+        corrupt.write((const char*)&bad, sizeof(bad));
+    }
+    CSRGraph<long long> rejected;
+    bool accepted = rejected.loadSnapshot(snapshotPath);
+    cout << "  越界终点的损坏快照: " << (accepted ? "被接受（结果不一致！）" : "已拒绝") << endl;
+
+    // 格式错误的小文件都应被拒绝；声明5×5、只有两个元素的Matrix Market保留全部5个顶点
+    const char* badInputs[] = {"99999999999999999999 3 4\n", "1 2 3abc\n", "1x 2 3\n", "1 2 -5\n"};
+    int rejectedCount = 0;
+    for (const char* text : badInputs) {
+        ofstream(textPath.c_str(), ios::binary) << text;
+        ThreadPool pool(1);
+        vector<CSRGraph<long long>::Edge> parsed;
+        vector<long long> ids;
+        bool undirected;
+        if (!readGraphText<int>(textPath, pool, parsed, undirected, ids)) rejectedCount++;
+    }
+    ofstream(mtxPath.c_str(), ios::binary) << "%%MatrixMarket matrix coordinate pattern general\n5 5 2\n1 2\n2 3\n";
+    ThreadPool pool(1);
+    CSRGraph<long long> sparse;
+    bool loaded = loadGraph(mtxPath, pool, sparse);
+    cout << "  越界整数、\"3abc\"、\"1x\"、负权重: " << rejectedCount << "/4已拒绝"
+         << (rejectedCount == 4 ? "" : "（结果不一致！）") << "; 5×5稀疏矩阵: "
+         << (loaded ? sparse.vertexCount() : 0) << "个顶点"
+         << (loaded && sparse.vertexCount() == 5 && sparse.indexOf(5) == 4 ? "" : "（结果不一致！）") << endl;
+
+    remove(textPath.c_str());
+    remove(mtxPath.c_str());
+    remove(snapshotPath.c_str());
+    cout << endl;
+}
+
+// 检查增量维护的结果与从头计算的结果一致
+template <typename VertexId>
+bool checkDynamic(const DynamicGraph<VertexId>& g) {
+    if (g.distances() != g.recomputeDistances()) return false;
+    vector<int> labels = g.componentLabels();
+    int count = labels.empty() ? 0 : *max_element(labels.begin(), labels.end()) + 1;
+    return count == g.componentCount();
+}
+
+void benchDynamic(int vertices) {
+    cout << "=== 动态图：增量最短路径与连通分量 ===" << endl;
+    cout << fixed << setprecision(3);
+
+    DynamicGraph<char> small;
+    for (const auto& e : graph1Edges()) {
+        small.insertEdge(e.from, e.to, e.weight);
+    }
+    small.setSource('A');
+    cout << "图1: A到H的距离 " << small.distance('H');
+    small.insertEdge('A', 'H', 1);
+    cout << ", 加边A-H(1)后 " << small.distance('H');
+    small.setWeight('A', 'H', 100);
+    cout << ", 改为100后 " << small.distance('H');
+    small.removeEdge('A', 'H');
+    cout << ", 删除后 " << small.distance('H') << ", 结果" << (checkDynamic(small) ? "一致" : "不一致！") << endl;
+
+    vector<CSRGraph<long long>::Edge> edges =
+        makeRandomEdges<long long>(vertices, (long long)vertices * 2, 1000, 12, scatteredId);
+    DynamicGraph<long long> g;
+    auto t = chrono::steady_clock::now();
+    for (const auto& e : edges) {
+        g.insertEdge(e.from, e.to, e.weight);
+    }
+    g.setSource(edges[0].from);
+    cout << g.vertexCount() << "个顶点, " << g.edgeCount() << "条边, 建图和初次Dijkstra " << elapsedMs(t) << " ms"
+         << endl;
+
+    t = chrono::steady_clock::now();
+    g.recomputeDistances();
+    g.componentLabels();
+    double fullTime = elapsedMs(t);
+
+    // 插入、删除、改权重各占三分之一；删除的是随机顶点的随机邻边，会不断切断生成树使图分裂
+    mt19937 rng(13);
+    const int updates = 3000;
+    const int checkpoints = 5;
+    long long touched = 0;
+    int applied = 0;
+    bool consistent = true;
+    double updateTime = 0;
+    for (int c = 0; c < checkpoints; c++) {
+        t = chrono::steady_clock::now();
+        for (int k = 0; k < updates / checkpoints; k++) {
+            int u = rng() % g.vertexCount();
+            int kind = rng() % 3;
+            bool ok;
+            if (kind == 0) {
+                int v = rng() % g.vertexCount();
+                ok = g.insertEdge(g.vertexAt(u), g.vertexAt(v), rng() % 1000 + 1);
+            } else if (g.degree(u) == 0) {
+                ok = false;
+            } else {
+                int v = g.arcAt(u, rng() % g.degree(u)).to;
+                if (kind == 1) {
+                    ok = g.removeEdge(g.vertexAt(u), g.vertexAt(v));
+                } else {
+                    ok = g.setWeight(g.vertexAt(u), g.vertexAt(v), rng() % 1000 + 1);
+                }
+            }
+            if (ok) {
+                applied++;
+                touched += g.touchedVertices();
+            }
+        }
+        updateTime += elapsedMs(t);
+        consistent = consistent && checkDynamic(g);
+    }
+
+    // 被拒绝的操作（重复插入、自环等）不改变图，只按实际生效的修改平均
+    cout << "  " << updates << "次尝试中" << applied << "次生效, 平均每次 "
+         << (applied ? updateTime * 1000 / applied : 0) << " us, 平均涉及 "
+         << (applied ? touched / applied : 0) << "个顶点" << endl;
+    cout << "  从头计算Dijkstra和连通分量: " << fullTime << " ms, 现有" << g.componentCount() << "个连通分量" << endl;
+    cout << "  增量结果与从头计算" << (consistent ? "一致" : "不一致！") << endl;
+}
+
+// --bench[=csr,...]运行性能测试，--vertices=N指定大规模测试的顶点数，
+// --threads=N指定并行测试的最大线程数，--delta=D指定delta-stepping的桶宽（默认按图自动选择）；
+// --load=FILE读取边表、Matrix Market或CSR快照并输出统计，加--save-snapshot=FILE时另存为快照
+bool benchEnabled(const string& selected, const string& name) {
+    if (selected.empty()) return true;
+    string list = "," + selected + ",";
+    return list.find("," + name + ",") != string::npos;
+}
+
+// --load的实现，Weight由文件中的权重类型决定
+template <typename Weight>
+bool loadCommand(const string& loadPath, const string& snapshotPath, int threads) {
+    ThreadPool pool(threads);
+    CSRGraph<long long, Weight> g;
+    auto t = chrono::steady_clock::now();
+    if (!loadGraph(loadPath, pool, g)) return false;
+    cout << fixed << setprecision(3);
+    cout << loadPath << ": " << g.vertexCount() << "个顶点, " << g.arcCount() << "条弧"
+         << (g.isSymmetric() ? "（无向）" : "（有向）") << (is_floating_point<Weight>::value ? ", 浮点权重" : "")
+         << ", 读取 " << elapsedMs(t) << " ms" << endl;
+    if (!snapshotPath.empty()) {
+        t = chrono::steady_clock::now();
+        if (!g.writeSnapshot(snapshotPath)) return false;
+        cout << "已写入快照" << snapshotPath << ", " << elapsedMs(t) << " ms" << endl;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool bench = false;
+    string benchList;
+    int vertices = 1000000;
+    int threads = max(4, (int)thread::hardware_concurrency());
+    int delta = 0;
+    string loadPath, snapshotPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bench") {
+            bench = true;
+        } else if (arg.compare(0, 8, "--bench=") == 0) {
+            bench = true;
+            benchList = arg.substr(8);
+        } else if (arg.compare(0, 11, "--vertices=") == 0) {
+            vertices = atoi(arg.c_str() + 11);
+            if (vertices < 2) {
+                cerr << "Error: --vertices must be at least 2" << endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            threads = atoi(arg.c_str() + 10);
+            if (threads < 1) {
+                cerr << "Error: --threads must be at least 1" << endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 8, "--delta=") == 0) {
+            delta = atoi(arg.c_str() + 8);
+            if (delta < 1) {
+                cerr << "Error: --delta must be at least 1" << endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--load=") == 0) {
+            loadPath = arg.substr(7);
+        } else if (arg.compare(0, 16, "--save-snapshot=") == 0) {
+            snapshotPath = arg.substr(16);
+        } else {
+            cerr << "Error: unknown option '" << arg << "'" << endl;
+            cerr << "Usage: " << argv[0] << " [--bench[=csr,dijkstra,delta,bfs,deep,mst,load,dynamic]] [--vertices=N] [--threads=N] [--delta=D]"
+                 << " [--load=FILE [--save-snapshot=FILE]]" << endl;
+            return 1;
+        }
+    }
+
+    if (!snapshotPath.empty() && loadPath.empty()) {
+        cerr << "Error: --save-snapshot requires --load" << endl;
+        return 1;
+    }
+    if (!loadPath.empty()) {
+        bool ok = hasRealWeights(loadPath) ? loadCommand<double>(loadPath, snapshotPath, threads)
+                                           : loadCommand<long long>(loadPath, snapshotPath, threads);
+        return ok ? 0 : 1;
+    }
+
+    if (bench) {
+        if (benchEnabled(benchList, "csr")) benchCSR(vertices);
+        if (benchEnabled(benchList, "dijkstra")) benchDijkstra(vertices);
+        if (benchEnabled(benchList, "delta")) benchDeltaStepping(vertices, threads, delta);
+        if (benchEnabled(benchList, "bfs")) benchParallelBFS(vertices, threads);
+        if (benchEnabled(benchList, "deep")) benchDeepGraphs(vertices);
+        if (benchEnabled(benchList, "mst")) benchMST(vertices, threads);
+        if (benchEnabled(benchList, "load")) benchLoader(vertices, threads);
+        if (benchEnabled(benchList, "dynamic")) benchDynamic(vertices);
+        return 0;
+    }
+
     cout << "=== 图1分析 ===" << endl;
     Graph g1 = createGraph1();
     
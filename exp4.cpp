@@ -6,29 +6,297 @@
 #include <cmath>
 #include <iomanip>
 #include <fstream>
-#include <windows.h>  // 用于高精度计时
+#include <map>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <new>
+#include <chrono>     // 用于高精度计时
+#include <string>
+#include <sstream>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>  // 文件映射
+#else
+#include <unistd.h>   // gethostname
+#include <fcntl.h>
+#include <sys/mman.h> // 文件映射
+#include <sys/stat.h>
+#endif
+#if defined(NMS_INSTRUMENT) && defined(__linux__)
+#include <linux/perf_event.h>  // 硬件计数器
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>    // AVX2 IoU内核
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>    // SSE2 IoU内核
+#endif
 
 using namespace std;
 
+// ==================== 堆分配计数 ====================
+// 替换全局operator new，统计堆分配次数，用于检查流式NMS在稳定状态下是否仍在分配内存。
+// 只在HeapAllocationScope存在期间计数；其余时间每次分配只多读一次不会被修改的标志，
+// 并行排序、测试矩阵等不需要计数的代码不必争用同一个原子计数器
+atomic<bool> heapAllocationCounting(false);
+atomic<long long> heapAllocationCount(0);
+
+class HeapAllocationScope {
+private:
+    long long before;
+    
+public:
+    HeapAllocationScope() {
+        before = heapAllocationCount.load();
+        heapAllocationCounting.store(true);
+    }
+    
+    ~HeapAllocationScope() {
+        heapAllocationCounting.store(false);
+    }
+    
+    // 从构造到现在（所有线程）的分配次数
+    long long count() const {
+        return heapAllocationCount.load() - before;
+    }
+};
+
+// 释放函数不允许内联：否则GCC会把new/delete配对看成malloc与free不匹配而报警告
+#if defined(__GNUC__)
+__attribute__((noinline))
+#elif defined(_MSC_VER)
+__declspec(noinline)
+#endif
+void releaseHeapBlock(void* p) {
+    free(p);
+}
+
+void* operator new(size_t size) {
+    if (heapAllocationCounting.load(memory_order_relaxed)) {
+        heapAllocationCount.fetch_add(1, memory_order_relaxed);
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    releaseHeapBlock(p);
+}
+
+void operator delete[](void* p) noexcept {
+    releaseHeapBlock(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    releaseHeapBlock(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    releaseHeapBlock(p);
+}
+
+// ==================== 热路径计数 ====================
+// 用-DNMS_INSTRUMENT编译时统计IoU计算、无重叠提前返回、抑制、排序比较/交换次数和搬动的字节数；
+// 不定义时NMS_COUNT展开为空语句，不影响正常计时。
+// 每个线程累加自己的计数器，线程退出时并入全局总数，所以并行排序/NMS的工作线程也会被统计。
+enum HotPathCounter {
+    CNT_IOU = 0,        // IoU计算次数（SIMD内核按通道数计）
+    CNT_EARLY_REJECT,   // calculateIoU中不相交直接返回的次数
+    CNT_SUPPRESS,       // 被抑制的框数
+    CNT_COMPARE,        // 排序比较次数
+    CNT_SWAP,           // 排序中交换/移动元素的次数
+    CNT_BYTES,          // 搬动的字节数
+    NUM_HOT_COUNTERS
+};
+
+const char* HOT_COUNTER_NAMES[] = {"iou", "early_reject", "suppress", "compare", "swap", "bytes"};
+
+#ifdef NMS_INSTRUMENT
+const bool HOT_PATH_INSTRUMENTED = true;
+
+atomic<long long> retiredCounters[NUM_HOT_COUNTERS];
+
+struct ThreadCounters {
+    long long value[NUM_HOT_COUNTERS];
+    
+    ThreadCounters() {
+        memset(value, 0, sizeof(value));
+    }
+    
+    ~ThreadCounters() {
+        for (int c = 0; c < NUM_HOT_COUNTERS; c++) retiredCounters[c] += value[c];
+    }
+};
+
+thread_local ThreadCounters threadCounters;
+
+#define NMS_COUNT(counter, n) (threadCounters.value[counter] += (n))
+#else
+const bool HOT_PATH_INSTRUMENTED = false;
+
+#define NMS_COUNT(counter, n) ((void)0)
+#endif
+
+// 当前累计值：已退出线程的总和加上调用线程自己的计数
+void readHotPathCounters(long long* out) {
+    for (int c = 0; c < NUM_HOT_COUNTERS; c++) {
+#ifdef NMS_INSTRUMENT
+        out[c] = retiredCounters[c].load() + threadCounters.value[c];
+#else
+        out[c] = 0;
+#endif
+    }
+}
+
+// 硬件计数器：Linux上通过perf_event读取（只统计用户态，包括之后创建的子线程）。
+// 未开启插桩、不是Linux，或内核不允许（perf_event_paranoid限制、容器内）时available()为false
+enum HardwareCounter {
+    HW_CYCLES = 0,
+    HW_CACHE_MISSES,
+    HW_BRANCH_MISSES,
+    NUM_HW_COUNTERS
+};
+
+const char* HW_COUNTER_NAMES[] = {"cycles", "cache_misses", "branch_misses"};
+
+class PerfEventCounters {
+private:
+    int fds[NUM_HW_COUNTERS];
+    
+public:
+    PerfEventCounters() {
+        for (int c = 0; c < NUM_HW_COUNTERS; c++) fds[c] = -1;
+#if defined(NMS_INSTRUMENT) && defined(__linux__)
+        const uint64_t configs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+                                    PERF_COUNT_HW_BRANCH_MISSES};
+        for (int c = 0; c < NUM_HW_COUNTERS; c++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[c];
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[c] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fds[c] < 0) {
+                close();
+                return;
+            }
+        }
+#endif
+    }
+    
+    ~PerfEventCounters() {
+        close();
+    }
+    
+    PerfEventCounters(const PerfEventCounters&) = delete;
+    PerfEventCounters& operator=(const PerfEventCounters&) = delete;
+    
+    bool available() const {
+        return fds[0] >= 0;
+    }
+    
+    void start() {
+#if defined(NMS_INSTRUMENT) && defined(__linux__)
+        for (int c = 0; c < NUM_HW_COUNTERS && available(); c++) {
+            ioctl(fds[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    
+    // 停止计数并读出start以来的值；不可用时全部为0
+    void stop(long long* out) {
+        for (int c = 0; c < NUM_HW_COUNTERS; c++) {
+            out[c] = 0;
+#if defined(NMS_INSTRUMENT) && defined(__linux__)
+            if (!available()) continue;
+            ioctl(fds[c], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            if (read(fds[c], &value, sizeof(value)) == sizeof(value)) out[c] = value;
+#endif
+        }
+    }
+    
+private:
+    void close() {
+        for (int c = 0; c < NUM_HW_COUNTERS; c++) {
+#if defined(NMS_INSTRUMENT) && defined(__linux__)
+            if (fds[c] >= 0) ::close(fds[c]);
+#endif
+            fds[c] = -1;
+        }
+    }
+};
+
+// 一个阶段（排序或NMS）内各计数器的增量
+struct PhaseCounters {
+    long long hotPath[NUM_HOT_COUNTERS];
+    long long hardware[NUM_HW_COUNTERS];
+    bool hasHardware;
+    
+    PhaseCounters() : hasHardware(false) {
+        memset(hotPath, 0, sizeof(hotPath));
+        memset(hardware, 0, sizeof(hardware));
+    }
+};
+
+// 围绕一个阶段读取计数器：begin()记下起点并开始硬件计数，end()填入增量
+class PhaseProbe {
+private:
+    PerfEventCounters& perf;
+    long long before[NUM_HOT_COUNTERS];
+    
+public:
+    explicit PhaseProbe(PerfEventCounters& counters) : perf(counters) {}
+    
+    void begin() {
+        readHotPathCounters(before);
+        perf.start();
+    }
+    
+    void end(PhaseCounters& phase) {
+        perf.stop(phase.hardware);
+        phase.hasHardware = perf.available();
+        readHotPathCounters(phase.hotPath);
+        for (int c = 0; c < NUM_HOT_COUNTERS; c++) phase.hotPath[c] -= before[c];
+    }
+};
+
 // ==================== 高精度计时 ====================
+// 基于std::chrono::steady_clock，Windows与Linux上行为一致
 class HighResTimer {
 private:
-    LARGE_INTEGER freq;
-    LARGE_INTEGER startTime;
+    chrono::steady_clock::time_point startTime;
     
 public:
     HighResTimer() {
-        QueryPerformanceFrequency(&freq);
+        start();
     }
     
     void start() {
-        QueryPerformanceCounter(&startTime);
+        startTime = chrono::steady_clock::now();
     }
     
     double elapsedMilliseconds() {
-        LARGE_INTEGER endTime;
-        QueryPerformanceCounter(&endTime);
-        return (double)(endTime.QuadPart - startTime.QuadPart) * 1000.0 / freq.QuadPart;
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
     }
 };
 
@@ -39,11 +307,12 @@ struct BoundingBox {
     float confidence;
     bool keep;
     int originalIndex;  // 保持原始索引
+    int classId;        // 类别编号（单类别检测时为0）
     
-    BoundingBox() : id(0), x1(0), y1(0), x2(0), y2(0), confidence(0), keep(true), originalIndex(0) {}
+    BoundingBox() : id(0), x1(0), y1(0), x2(0), y2(0), confidence(0), keep(true), originalIndex(0), classId(0) {}
     
-    BoundingBox(int i, float x, float y, float w, float h, float conf, int idx) 
-        : id(i), x1(x), y1(y), x2(x+w), y2(y+h), confidence(conf), keep(true), originalIndex(idx) {}
+    BoundingBox(int i, float x, float y, float w, float h, float conf, int idx, int cls = 0) 
+        : id(i), x1(x), y1(y), x2(x+w), y2(y+h), confidence(conf), keep(true), originalIndex(idx), classId(cls) {}
     
     float area() const {
         return (x2 - x1) * (y2 - y1);
@@ -54,17 +323,112 @@ struct BoundingBox {
 inline float my_max(float a, float b) { return a > b ? a : b; }
 inline float my_min(float a, float b) { return a < b ? a : b; }
 
+// ==================== 任务线程池 ====================
+// 固定数量的工作线程从共享队列取任务。等待任务组完成的线程也会帮忙执行队列中的任务，
+// 因此任务内部可以继续派生子任务而不会死锁；numThreads为1时不创建工作线程，全部由调用者执行。
+class TaskPool {
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex lock;
+    condition_variable available;
+    bool stopping;
+
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> guard(lock);
+                available.wait(guard, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = tasks.front();
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    TaskPool(int numThreads) : stopping(false) {
+        for (int t = 1; t < numThreads; t++) {
+            workers.push_back(thread(&TaskPool::workerLoop, this));
+        }
+    }
+
+    ~TaskPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        available.notify_all();
+        for (int t = 0; t < (int)workers.size(); t++) {
+            workers[t].join();
+        }
+    }
+
+    // 参与计算的线程数（含调用者）
+    int size() const { return workers.size() + 1; }
+
+    void submit(const function<void()>& task) {
+        {
+            lock_guard<mutex> guard(lock);
+            tasks.push_back(task);
+        }
+        available.notify_one();
+    }
+
+    // 取出并执行一个排队中的任务，队列为空时返回false
+    bool runPendingTask() {
+        function<void()> task;
+        {
+            lock_guard<mutex> guard(lock);
+            if (tasks.empty()) return false;
+            task = tasks.back();   // 取最新的任务，局部性更好
+            tasks.pop_back();
+        }
+        task();
+        return true;
+    }
+};
+
+// 一组可等待的任务（fork-join）
+class TaskGroup {
+private:
+    TaskPool& pool;
+    atomic<int> pending;
+
+public:
+    TaskGroup(TaskPool& p) : pool(p), pending(0) {}
+
+    void run(const function<void()>& task) {
+        pending++;
+        pool.submit([this, task] {
+            task();
+            pending--;
+        });
+    }
+
+    void wait() {
+        while (pending > 0) {
+            if (!pool.runPendingTask()) this_thread::yield();
+        }
+    }
+};
+
 // ==================== 排序算法实现 ====================
 namespace SortAlgorithms {
     
     // 稳定的比较函数（相同置信度时按原始索引排序）
     bool compareBoxes(const BoundingBox& a, const BoundingBox& b) {
+        NMS_COUNT(CNT_COMPARE, 1);
         if (a.confidence != b.confidence)
             return a.confidence > b.confidence;
         return a.originalIndex < b.originalIndex;
     }
     
-    // 1. 快速排序（需要稳定版本）
+    // 1. 快速排序。Hoare划分本身不稳定，但compareBoxes在置信度相同时比较原始索引，
+    // 是严格全序（originalIndex唯一时），所以结果与稳定排序相同。
+    // 中间元素作枢轴、没有退化保护，对抗性输入下会退化到O(n^2)，需要保证时用pdqSort
     void quickSortStable(vector<BoundingBox>& arr, int left, int right) {
         if (left >= right) return;
         
@@ -76,6 +440,8 @@ namespace SortAlgorithms {
             while (compareBoxes(pivot, arr[j])) j--;
             if (i <= j) {
                 swap(arr[i], arr[j]);
+                NMS_COUNT(CNT_SWAP, 1);
+                NMS_COUNT(CNT_BYTES, 3 * sizeof(BoundingBox));
                 i++;
                 j--;
             }
@@ -91,9 +457,10 @@ namespace SortAlgorithms {
     }
     
     // 2. 归并排序（自然稳定）
-    void merge(vector<BoundingBox>& arr, int left, int mid, int right) {
-        vector<BoundingBox> temp(right - left + 1);
-        int i = left, j = mid + 1, k = 0;
+    // temp是整个排序共用的辅助数组，避免每次合并都重新分配；
+    // 合并[left, right]只使用temp的同一段，互不重叠的区间可以同时合并
+    void merge(vector<BoundingBox>& arr, vector<BoundingBox>& temp, int left, int mid, int right) {
+        int i = left, j = mid + 1, k = left;
         
         while (i <= mid && j <= right) {
             if (compareBoxes(arr[i], arr[j])) {
@@ -106,60 +473,73 @@ namespace SortAlgorithms {
         while (i <= mid) temp[k++] = arr[i++];
         while (j <= right) temp[k++] = arr[j++];
         
-        for (int idx = 0; idx < k; idx++) {
-            arr[left + idx] = temp[idx];
+        for (int idx = left; idx < k; idx++) {
+            arr[idx] = temp[idx];
         }
+        NMS_COUNT(CNT_SWAP, 2 * (k - left));
+        NMS_COUNT(CNT_BYTES, 2 * (k - left) * sizeof(BoundingBox));
     }
     
-    void mergeSort(vector<BoundingBox>& arr, int left, int right) {
+    void mergeSort(vector<BoundingBox>& arr, vector<BoundingBox>& temp, int left, int right) {
         if (left >= right) return;
         
         int mid = left + (right - left) / 2;
-        mergeSort(arr, left, mid);
-        mergeSort(arr, mid + 1, right);
-        merge(arr, left, mid, right);
+        mergeSort(arr, temp, left, mid);
+        mergeSort(arr, temp, mid + 1, right);
+        merge(arr, temp, left, mid, right);
     }
     
     void mergeSort(vector<BoundingBox>& arr) {
         if (arr.empty()) return;
-        mergeSort(arr, 0, arr.size() - 1);
+        vector<BoundingBox> temp(arr.size());
+        mergeSort(arr, temp, 0, arr.size() - 1);
     }
     
-    // 3. 堆排序（需要修改为稳定版本）
-    void heapify(vector<BoundingBox>& arr, int n, int i) {
+    // 3. 堆排序（compareBoxes是严格全序，结果与稳定排序相同）
+    // 对arr[base, base+n)建堆：堆顶是排序后应该排在最后的框，逐个换到区间末尾
+    void heapify(vector<BoundingBox>& arr, int base, int n, int i) {
         int largest = i;
         int left = 2 * i + 1;
         int right = 2 * i + 2;
         
-        if (left < n && compareBoxes(arr[left], arr[largest])) {
+        if (left < n && compareBoxes(arr[base + largest], arr[base + left])) {
             largest = left;
         }
         
-        if (right < n && compareBoxes(arr[right], arr[largest])) {
+        if (right < n && compareBoxes(arr[base + largest], arr[base + right])) {
             largest = right;
         }
         
         if (largest != i) {
-            swap(arr[i], arr[largest]);
-            heapify(arr, n, largest);
+            swap(arr[base + i], arr[base + largest]);
+            NMS_COUNT(CNT_SWAP, 1);
+            NMS_COUNT(CNT_BYTES, 3 * sizeof(BoundingBox));
+            heapify(arr, base, n, largest);
         }
     }
     
-    void heapSort(vector<BoundingBox>& arr) {
-        int n = arr.size();
+    // 对[left, right)堆排序
+    void heapSortRange(vector<BoundingBox>& arr, int left, int right) {
+        int n = right - left;
         
         // 建堆
         for (int i = n / 2 - 1; i >= 0; i--) {
-            heapify(arr, n, i);
+            heapify(arr, left, n, i);
         }
         
         // 提取元素
         for (int i = n - 1; i > 0; i--) {
-            swap(arr[0], arr[i]);
-            heapify(arr, i, 0);
+            swap(arr[left], arr[left + i]);
+            NMS_COUNT(CNT_SWAP, 1);
+            NMS_COUNT(CNT_BYTES, 3 * sizeof(BoundingBox));
+            heapify(arr, left, i, 0);
         }
     }
     
+    void heapSort(vector<BoundingBox>& arr) {
+        heapSortRange(arr, 0, arr.size());
+    }
+    
     // 4. 插入排序（自然稳定）
     void insertionSort(vector<BoundingBox>& arr) {
         for (int i = 1; i < arr.size(); i++) {
@@ -168,315 +548,4454 @@ namespace SortAlgorithms {
             
             while (j >= 0 && compareBoxes(key, arr[j])) {
                 arr[j + 1] = arr[j];
+                NMS_COUNT(CNT_SWAP, 1);
+                NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
                 j--;
             }
             arr[j + 1] = key;
         }
     }
-}
-
-// 计算IoU
-float calculateIoU(const BoundingBox& box1, const BoundingBox& box2) {
-    float interX1 = my_max(box1.x1, box2.x1);
-    float interY1 = my_max(box1.y1, box2.y1);
-    float interX2 = my_min(box1.x2, box2.x2);
-    float interY2 = my_min(box1.y2, box2.y2);
-    
-    if (interX2 <= interX1 || interY2 <= interY1) {
-        return 0.0f;
-    }
     
-    float interArea = (interX2 - interX1) * (interY2 - interY1);
-    float unionArea = box1.area() + box2.area() - interArea;
-    
-    if (unionArea <= 0) return 0.0f;
-    return interArea / unionArea;
-}
-
-// 数据生成器
-class DataGenerator {
-private:
-    static int seedCounter;
+    // 排序键与框下标组成的紧凑对，线性时间排序只搬动它们，最后一次性按顺序收集框
+    struct KeyIndex {
+        uint64_t key;
+        int index;
+    };
     
-    // 简单的随机数生成器
-    static unsigned int randomInt() {
-        static unsigned int seed = (unsigned int)time(NULL) + (seedCounter++);
-        seed = seed * 1103515245 + 12345;
-        return seed;
+    // 把(置信度降序, 原始索引升序)编码成一个64位无符号键，键升序即compareBoxes顺序：
+    // 高32位是置信度的位模式（翻转后负数、正数都按数值单调），再取反得到降序；
+    // 低32位是原始索引（翻转符号位后有符号数也按数值单调）
+    inline uint64_t sortKey(float confidence, int originalIndex) {
+        float conf = confidence == 0.0f ? 0.0f : confidence;  // -0与+0视为相等
+        uint32_t bits;
+        memcpy(&bits, &conf, 4);
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        uint32_t idx = (uint32_t)originalIndex ^ 0x80000000u;
+        return ((uint64_t)~bits << 32) | idx;
     }
     
-public:
-    // 生成0-1的随机浮点数
-    static float randomFloat() {
-        return (float)(randomInt() & 0x7FFF) / 32767.0f;
+    inline uint64_t sortKey(const BoundingBox& box) {
+        return sortKey(box.confidence, box.originalIndex);
     }
     
-    // 生成近似正态分布
-    static float randomNormal(float mean, float stddev) {
-        float sum = 0.0f;
-        for (int i = 0; i < 12; i++) {
-            sum += randomFloat();
+    vector<KeyIndex> makeKeys(const vector<BoundingBox>& arr) {
+        vector<KeyIndex> keys(arr.size());
+        for (int i = 0; i < (int)arr.size(); i++) {
+            keys[i].key = sortKey(arr[i]);
+            keys[i].index = i;
         }
-        return mean + (sum - 6.0f) * stddev;
+        NMS_COUNT(CNT_BYTES, arr.size() * sizeof(KeyIndex));
+        return keys;
     }
     
-    // 随机分布生成
-    static vector<BoundingBox> generateRandomBoxes(int numBoxes) {
-        vector<BoundingBox> boxes;
-        
-        for (int i = 0; i < numBoxes; i++) {
-            float width = randomFloat() * 0.2f + 0.05f;
-            float height = randomFloat() * 0.2f + 0.05f;
-            float x = randomFloat() * (1.0f - width);
-            float y = randomFloat() * (1.0f - height);
-            float confidence = randomFloat();
-            
-            boxes.push_back(BoundingBox(i, x, y, width, height, confidence, i));
+    // 按排好序的键一次性重排框
+    void gatherByKeys(vector<BoundingBox>& arr, const KeyIndex* keys) {
+        vector<BoundingBox> sorted(arr.size());
+        for (int i = 0; i < (int)arr.size(); i++) {
+            sorted[i] = arr[keys[i].index];
         }
-        
-        return boxes;
+        NMS_COUNT(CNT_SWAP, arr.size());
+        NMS_COUNT(CNT_BYTES, arr.size() * sizeof(BoundingBox));
+        arr.swap(sorted);
     }
     
-    // 聚集分布生成
-    static vector<BoundingBox> generateClusteredBoxes(int numBoxes, int numClusters = 10) {
-        vector<BoundingBox> boxes;
-        
-        // 生成聚类中心
-        float* clusterCentersX = new float[numClusters];
-        float* clusterCentersY = new float[numClusters];
-        for (int i = 0; i < numClusters; i++) {
-            clusterCentersX[i] = randomFloat();
-            clusterCentersY[i] = randomFloat();
+    // 5. 基数排序（LSD，每趟8位，线性时间）
+    // 对keys[0, n)排序，buffer是同样大小的辅助空间，count是8*256个计数器。
+    // 两个数组轮流作为输出，返回最终存放结果的那个；不分配内存，可在复用的缓冲区上反复调用
+    KeyIndex* radixSortKeys(KeyIndex* keys, KeyIndex* buffer, int n, int* count) {
+        // 一次遍历统计8趟的直方图
+        memset(count, 0, 8 * 256 * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            for (int pass = 0; pass < 8; pass++) {
+                count[pass * 256 + ((keys[i].key >> (pass * 8)) & 0xFF)]++;
+            }
         }
         
-        for (int i = 0; i < numBoxes; i++) {
-            int clusterIdx = i % numClusters;
-            float centerX = clusterCentersX[clusterIdx];
-            float centerY = clusterCentersY[clusterIdx];
-            
-            float width = 0.1f;
-            float height = 0.1f;
-            
-            // 在聚类中心周围生成
-            float x = centerX + randomNormal(0, 0.1f);
-            float y = centerY + randomNormal(0, 0.1f);
+        for (int pass = 0; pass < 8 && n > 1; pass++) {
+            int* c = &count[pass * 256];
+            int shift = pass * 8;
+            // 所有键在这一字节上相同，这一趟不会改变顺序
+            if (c[(keys[0].key >> shift) & 0xFF] == n) continue;
             
-            // 确保在范围内
-            x = my_max(0.0f, my_min(x, 1.0f - width));
-            y = my_max(0.0f, my_min(y, 1.0f - height));
-            
-            // 置信度
-            float dx = (x + width/2) - centerX;
-            float dy = (y + height/2) - centerY;
-            float distance = dx*dx + dy*dy;
-            float confidence = 0.8f + randomFloat() * 0.2f - distance * 2.0f;
-            confidence = my_max(0.1f, my_min(1.0f, confidence));
-            
-            boxes.push_back(BoundingBox(i, x, y, width, height, confidence, i));
+            int offset = 0;
+            for (int b = 0; b < 256; b++) {
+                int t = c[b];
+                c[b] = offset;
+                offset += t;
+            }
+            for (int i = 0; i < n; i++) {
+                buffer[c[(keys[i].key >> shift) & 0xFF]++] = keys[i];
+            }
+            NMS_COUNT(CNT_SWAP, n);
+            NMS_COUNT(CNT_BYTES, n * sizeof(KeyIndex));
+            swap(keys, buffer);
         }
-        
-        delete[] clusterCentersX;
-        delete[] clusterCentersY;
-        return boxes;
+        return keys;
     }
-};
-
-int DataGenerator::seedCounter = 0;
-
-// ==================== 性能测试 ====================
-struct PerformanceResult {
-    string sortAlgorithm;
-    int numBoxes;
-    string distribution;
-    double sortTime;
-    double nmsTime;
-    double totalTime;
-    int remainingBoxes;
-};
-
-// NMS处理函数
-vector<BoundingBox> processNMS(vector<BoundingBox> boxes, float iouThreshold = 0.5f) {
-    vector<BoundingBox> result;
     
-    for (int i = 0; i < boxes.size(); i++) {
-        if (!boxes[i].keep) continue;
-        
-        result.push_back(boxes[i]);
+    void radixSort(vector<BoundingBox>& arr) {
+        int n = arr.size();
+        if (n <= 1) return;
         
-        for (int j = i + 1; j < boxes.size(); j++) {
-            if (!boxes[j].keep) continue;
-            
-            float iou = calculateIoU(boxes[i], boxes[j]);
-            if (iou > iouThreshold) {
-                boxes[j].keep = false;
-            }
-        }
+        vector<KeyIndex> keys = makeKeys(arr);
+        vector<KeyIndex> buffer(n);
+        vector<int> count(8 * 256);
+        KeyIndex* sorted = radixSortKeys(keys.data(), buffer.data(), n, count.data());
+        gatherByKeys(arr, sorted);
     }
     
-    return result;
-}
-
-// 运行测试（多次测量取平均）
-PerformanceResult runTest(vector<BoundingBox> boxes, int sortType, 
-                         const string& algoName, const string& distName, int repetitions = 3) {
-    PerformanceResult result;
-    result.sortAlgorithm = algoName;
-    result.numBoxes = boxes.size();
-    result.distribution = distName;
-    
-    double totalSortTime = 0;
-    double totalNmsTime = 0;
-    double totalTime = 0;
-    
-    HighResTimer timer;
-    
-    for (int rep = 0; rep < repetitions; rep++) {
-        // 复制原始数据（重置状态）
-        vector<BoundingBox> boxesCopy;
-        for (int i = 0; i < boxes.size(); i++) {
-            boxesCopy.push_back(boxes[i]);
-            boxesCopy[i].keep = true;
-        }
+    // 6. 桶排序（按置信度直方图分桶，桶内插入排序）
+    void bucketSort(vector<BoundingBox>& arr) {
+        int n = arr.size();
+        if (n <= 1) return;
         
-        timer.start();
+        vector<KeyIndex> keys = makeKeys(arr);
         
-        // 排序阶段
-        double sortStartTime = timer.elapsedMilliseconds();
-        switch(sortType) {
-            case 0: SortAlgorithms::quickSort(boxesCopy); break;
-            case 1: SortAlgorithms::mergeSort(boxesCopy); break;
-            case 2: SortAlgorithms::heapSort(boxesCopy); break;
-            case 3: SortAlgorithms::insertionSort(boxesCopy); break;
+        // 置信度在[0,1]内，桶号随置信度单调递减；越界值归入两端的桶，桶内排序仍按完整键
+        int numBuckets = n;
+        vector<int> bucketOf(n);
+        vector<int> start(numBuckets + 1, 0);
+        for (int i = 0; i < n; i++) {
+            float conf = my_max(0.0f, my_min(1.0f, arr[i].confidence));
+            int b = (numBuckets - 1) - (int)(conf * (numBuckets - 1));
+            bucketOf[i] = b;
+            start[b + 1]++;
+        }
+        for (int b = 0; b < numBuckets; b++) {
+            start[b + 1] += start[b];
         }
-        double sortEndTime = timer.elapsedMilliseconds();
-        
-        // NMS阶段
-        double nmsStartTime = timer.elapsedMilliseconds();
-        vector<BoundingBox> remaining = processNMS(boxesCopy);
-        double nmsEndTime = timer.elapsedMilliseconds();
         
-        double endTime = timer.elapsedMilliseconds();
+        vector<KeyIndex> sorted(n);
+        vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; i++) {
+            sorted[fill[bucketOf[i]]++] = keys[i];
+        }
         
-        if (rep == 0) {  // 只记录第一次的保留框数
-            result.remainingBoxes = remaining.size();
+        for (int b = 0; b < numBuckets; b++) {
+            for (int i = start[b] + 1; i < start[b + 1]; i++) {
+                KeyIndex k = sorted[i];
+                int j = i - 1;
+                while (j >= start[b] && sorted[j].key > k.key) {
+                    sorted[j + 1] = sorted[j];
+                    j--;
+                }
+                sorted[j + 1] = k;
+            }
         }
         
-        totalSortTime += (sortEndTime - sortStartTime);
-        totalNmsTime += (nmsEndTime - nmsStartTime);
-        totalTime += endTime;
+        gatherByKeys(arr, sorted.data());
     }
     
-    // 计算平均时间
-    result.sortTime = totalSortTime / repetitions;
-    result.nmsTime = totalNmsTime / repetitions;
-    result.totalTime = totalTime / repetitions;
-    
-    return result;
-}
-
-// ==================== 主函数 ====================
-int main() {
-    cout << "============================================\n";
-    cout << "      NMS算法性能测试实验（修正版）        \n";
-    cout << "============================================\n\n";
-    
-    // 测试数据规模
-    int testSizes[] = {100, 500, 1000, 2000, 5000};
-    int numTests = 5;
+    // 7. 索引排序：只对16字节的(键, 下标)对做归并排序，最后一次性收集框。
+    // 比较只看一个64位整数，移动的数据量不到直接排序BoundingBox的一半，
+    // 辅助数组在整个排序中只分配一次
+    void mergeKeys(vector<KeyIndex>& keys, vector<KeyIndex>& temp, int left, int mid, int right) {
+        int i = left, j = mid + 1, k = left;
+        while (i <= mid && j <= right) {
+            if (keys[j].key < keys[i].key) {
+                temp[k++] = keys[j++];
+            } else {
+                temp[k++] = keys[i++];
+            }
+        }
+        while (i <= mid) temp[k++] = keys[i++];
+        while (j <= right) temp[k++] = keys[j++];
+        
+        for (int idx = left; idx <= right; idx++) {
+            keys[idx] = temp[idx];
+        }
+        NMS_COUNT(CNT_COMPARE, right - left);
+        NMS_COUNT(CNT_SWAP, 2 * (right - left + 1));
+        NMS_COUNT(CNT_BYTES, 2 * (right - left + 1) * sizeof(KeyIndex));
+    }
     
-    vector<PerformanceResult> allResults;
+    void mergeSortKeys(vector<KeyIndex>& keys, vector<KeyIndex>& temp, int left, int right) {
+        // 小区间直接插入排序
+        if (right - left < 16) {
+            for (int i = left + 1; i <= right; i++) {
+                KeyIndex k = keys[i];
+                int j = i - 1;
+                while (j >= left && keys[j].key > k.key) {
+                    keys[j + 1] = keys[j];
+                    j--;
+                }
+                keys[j + 1] = k;
+            }
+            return;
+        }
+        
+        int mid = left + (right - left) / 2;
+        mergeSortKeys(keys, temp, left, mid);
+        mergeSortKeys(keys, temp, mid + 1, right);
+        if (keys[mid].key <= keys[mid + 1].key) return;  // 两半已经有序
+        mergeKeys(keys, temp, left, mid, right);
+    }
     
-    // 算法名称
-    string algoNames[] = {"快速排序", "归并排序", "堆排序", "插入排序"};
+    void indexSort(vector<BoundingBox>& arr) {
+        if (arr.size() <= 1) return;
+        
+        vector<KeyIndex> keys = makeKeys(arr);
+        vector<KeyIndex> temp(keys.size());
+        mergeSortKeys(keys, temp, 0, keys.size() - 1);
+        gatherByKeys(arr, keys.data());
+    }
     
-    cout << "开始性能测试（每个测试重复3次取平均）...\n\n";
+    // 8. 并行快速排序：划分后左半区间作为新任务，右半区间由当前线程继续；
+    // 区间小于PARALLEL_CUTOFF时改用顺序快速排序。
+    // compareBoxes在置信度相同时按原始索引排序，是严格全序，所以结果与任何稳定排序相同
+    const int PARALLEL_CUTOFF = 16384;
     
-    for (int i = 0; i < numTests; i++) {
-        int size = testSizes[i];
-        
-        cout << "测试数据规模: " << size << "个边界框\n";
-        
-        // 测试随机分布
-        cout << "  随机分布测试:\n";
-        vector<BoundingBox> randomBoxes = DataGenerator::generateRandomBoxes(size);
-        
-        for (int algo = 0; algo < 4; algo++) {
-            // 插入排序只测试小数据集
-            if (algo == 3 && size > 1000) continue;
+    void parallelQuickSort(vector<BoundingBox>& arr, int left, int right, TaskGroup& group) {
+        while (right - left >= PARALLEL_CUTOFF) {
+            int i = left, j = right;
+            BoundingBox pivot = arr[(left + right) / 2];
             
-            PerformanceResult result = runTest(randomBoxes, algo, 
-                                             algoNames[algo], "随机分布", 3);
-            allResults.push_back(result);
+            while (i <= j) {
+                while (compareBoxes(arr[i], pivot)) i++;
+                while (compareBoxes(pivot, arr[j])) j--;
+                if (i <= j) {
+                    swap(arr[i], arr[j]);
+                    NMS_COUNT(CNT_SWAP, 1);
+                    NMS_COUNT(CNT_BYTES, 3 * sizeof(BoundingBox));
+                    i++;
+                    j--;
+                }
+            }
             
-            cout << "    " << algoNames[algo] << ": "
-                 << fixed << setprecision(3) << result.totalTime << " ms, "
-                 << "保留" << result.remainingBoxes << "个框"
-                 << " (排序:" << result.sortTime << " ms, NMS:" << result.nmsTime << " ms)\n";
+            int subLeft = left, subRight = j;
+            group.run([&arr, subLeft, subRight, &group] {
+                parallelQuickSort(arr, subLeft, subRight, group);
+            });
+            left = i;
         }
-        
-        // 测试聚集分布（只测试中等数据量）
-        if (size <= 2000) {
-            cout << "  聚集分布测试:\n";
-            vector<BoundingBox> clusteredBoxes = DataGenerator::generateClusteredBoxes(size);
-            
-            for (int algo = 0; algo < 3; algo++) { // 不测试插入排序
-                PerformanceResult result = runTest(clusteredBoxes, algo,
-                                                 algoNames[algo], "聚集分布", 3);
-                allResults.push_back(result);
-                
-                cout << "    " << algoNames[algo] << ": "
-                     << fixed << setprecision(3) << result.totalTime << " ms, "
-                     << "保留" << result.remainingBoxes << "个框"
-                     << " (排序:" << result.sortTime << " ms, NMS:" << result.nmsTime << " ms)\n";
+        quickSortStable(arr, left, right);
+    }
+    
+    void parallelQuickSort(vector<BoundingBox>& arr, int numThreads) {
+        if (arr.empty()) return;
+        TaskPool pool(numThreads);
+        TaskGroup group(pool);
+        parallelQuickSort(arr, 0, arr.size() - 1, group);
+        group.wait();
+    }
+    
+    // 9. 并行归并排序：两半并行排序后并行合并。
+    // 合并时取较长一段的中点，在另一段中二分出它的位置，把合并拆成两个互不相干的子合并。
+    // 左段元素与右段“相等”时左段优先，保持归并排序的稳定性
+    void parallelMergeInto(const vector<BoundingBox>& src, vector<BoundingBox>& dst,
+                           int l1, int r1, int l2, int r2, int out, TaskGroup& group) {
+        int n1 = r1 - l1, n2 = r2 - l2;   // 半开区间[l1, r1)与[l2, r2)
+        if (n1 + n2 < PARALLEL_CUTOFF) {
+            int i = l1, j = l2, k = out;
+            while (i < r1 && j < r2) {
+                if (compareBoxes(src[j], src[i])) {
+                    dst[k++] = src[j++];
+                } else {
+                    dst[k++] = src[i++];
+                }
             }
+            while (i < r1) dst[k++] = src[i++];
+            while (j < r2) dst[k++] = src[j++];
+            return;
         }
         
-        cout << endl;
+        int m1, m2;
+        if (n1 >= n2) {
+            // 左段中点之前的右段元素：严格排在它前面的那些
+            m1 = l1 + n1 / 2;
+            m2 = lower_bound(src.begin() + l2, src.begin() + r2, src[m1], compareBoxes) - src.begin();
+        } else {
+            // 右段中点之前的左段元素：不排在它后面的那些（相等时左段优先）
+            m2 = l2 + n2 / 2;
+            m1 = upper_bound(src.begin() + l1, src.begin() + r1, src[m2], compareBoxes) - src.begin();
+        }
+        int mid = out + (m1 - l1) + (m2 - l2);
+        group.run([&src, &dst, l1, m1, l2, m2, out, &group] {
+            parallelMergeInto(src, dst, l1, m1, l2, m2, out, group);
+        });
+        parallelMergeInto(src, dst, m1, r1, m2, r2, mid, group);
     }
     
-    // 输出结果表格
-    cout << "\n============================================\n";
-    cout << "             性能测试结果汇总               \n";
-    cout << "============================================\n";
-    cout << left << setw(12) << "算法" 
-         << setw(8) << "数据量" 
-         << setw(12) << "分布类型" 
+    // 排序[left, right)，结果写回arr
+    void parallelMergeSort(vector<BoundingBox>& arr, vector<BoundingBox>& temp,
+                           int left, int right, TaskPool& pool) {
+        if (right - left < PARALLEL_CUTOFF) {
+            if (right - left > 1) mergeSort(arr, temp, left, right - 1);
+            return;
+        }
+        
+        int mid = left + (right - left) / 2;
+        {
+            TaskGroup halves(pool);
+            halves.run([&arr, &temp, left, mid, &pool] {
+                parallelMergeSort(arr, temp, left, mid, pool);
+            });
+            parallelMergeSort(arr, temp, mid, right, pool);
+            halves.wait();
+        }
+        if (!compareBoxes(arr[mid], arr[mid - 1])) return;  // 两半已经有序
+        
+        TaskGroup merging(pool);
+        parallelMergeInto(arr, temp, left, mid, mid, right, left, merging);
+        merging.wait();
+        
+        // 分块并行拷回
+        TaskGroup copying(pool);
+        for (int start = left; start < right; start += PARALLEL_CUTOFF) {
+            int end = start + PARALLEL_CUTOFF < right ? start + PARALLEL_CUTOFF : right;
+            copying.run([&arr, &temp, start, end] {
+                copy(temp.begin() + start, temp.begin() + end, arr.begin() + start);
+            });
+        }
+        copying.wait();
+    }
+    
+    void parallelMergeSort(vector<BoundingBox>& arr, int numThreads) {
+        if (arr.size() <= 1) return;
+        vector<BoundingBox> temp(arr.size());
+        TaskPool pool(numThreads);
+        parallelMergeSort(arr, temp, 0, arr.size(), pool);
+    }
+    
+    // 10. 模式击败快速排序（pdqsort风格的混合排序）：
+    //   - 小于PDQ_INSERTION_THRESHOLD的区间用插入排序；
+    //   - 枢轴取三数中值，大区间取九数中值；
+    //   - 划分时没有发生交换说明区间很可能已经有序，先尝试有限步数的插入排序，成功就直接结束；
+    //   - 划分严重不平衡（较小一侧不到1/8）时交换几个位置打破对抗性模式，
+    //     累计log2(n)次仍不平衡就改用堆排序，保证最坏O(n log n)。
+    const int PDQ_INSERTION_THRESHOLD = 24;
+    const int PDQ_NINTHER_THRESHOLD = 128;
+    const int PDQ_PARTIAL_INSERTION_LIMIT = 8;
+    
+    // 对[left, right)插入排序
+    void insertionSortRange(vector<BoundingBox>& arr, int left, int right) {
+        for (int i = left + 1; i < right; i++) {
+            if (!compareBoxes(arr[i], arr[i - 1])) continue;
+            BoundingBox key = arr[i];
+            int j = i - 1;
+            do {
+                arr[j + 1] = arr[j];
+                NMS_COUNT(CNT_SWAP, 1);
+                NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+                j--;
+            } while (j >= left && compareBoxes(key, arr[j]));
+            arr[j + 1] = key;
+        }
+    }
+    
+    // 插入排序，但移动次数超过PDQ_PARTIAL_INSERTION_LIMIT就放弃；返回区间是否已排好
+    bool partialInsertionSort(vector<BoundingBox>& arr, int left, int right) {
+        int moves = 0;
+        for (int i = left + 1; i < right; i++) {
+            if (!compareBoxes(arr[i], arr[i - 1])) continue;
+            BoundingBox key = arr[i];
+            int j = i - 1;
+            do {
+                arr[j + 1] = arr[j];
+                j--;
+            } while (j >= left && compareBoxes(key, arr[j]));
+            arr[j + 1] = key;
+            moves += i - j - 1;
+            NMS_COUNT(CNT_SWAP, i - j - 1);
+            NMS_COUNT(CNT_BYTES, (i - j - 1) * sizeof(BoundingBox));
+            if (moves > PDQ_PARTIAL_INSERTION_LIMIT) return false;
+        }
+        return true;
+    }
+    
+    inline void swapBoxes(vector<BoundingBox>& arr, int a, int b) {
+        swap(arr[a], arr[b]);
+        NMS_COUNT(CNT_SWAP, 1);
+        NMS_COUNT(CNT_BYTES, 3 * sizeof(BoundingBox));
+    }
+    
+    // 使arr[a], arr[b], arr[c]按排序顺序排列，中值落在b
+    void sort3(vector<BoundingBox>& arr, int a, int b, int c) {
+        if (compareBoxes(arr[b], arr[a])) swapBoxes(arr, a, b);
+        if (compareBoxes(arr[c], arr[b])) swapBoxes(arr, b, c);
+        if (compareBoxes(arr[b], arr[a])) swapBoxes(arr, a, b);
+    }
+    
+    // 以arr[left]为枢轴划分[left, right)，返回枢轴的最终位置。
+    // 选枢轴时保证了区间末端附近有不排在枢轴之前的元素，所以向右的扫描不会越界。
+    // alreadyPartitioned为true表示划分过程中没有发生交换
+    int partitionRight(vector<BoundingBox>& arr, int left, int right, bool& alreadyPartitioned) {
+        BoundingBox pivot = arr[left];
+        int first = left, last = right;
+        
+        while (compareBoxes(arr[++first], pivot));
+        if (first - 1 == left) {
+            while (first < last && !compareBoxes(arr[--last], pivot));
+        } else {
+            while (!compareBoxes(arr[--last], pivot));
+        }
+        
+        alreadyPartitioned = first >= last;
+        while (first < last) {
+            swapBoxes(arr, first, last);
+            while (compareBoxes(arr[++first], pivot));
+            while (!compareBoxes(arr[--last], pivot));
+        }
+        
+        int pivotPos = first - 1;
+        arr[left] = arr[pivotPos];
+        arr[pivotPos] = pivot;
+        NMS_COUNT(CNT_BYTES, 2 * sizeof(BoundingBox));
+        return pivotPos;
+    }
+    
+    void pdqSortLoop(vector<BoundingBox>& arr, int left, int right, int badAllowed) {
+        while (true) {
+            int size = right - left;
+            if (size < PDQ_INSERTION_THRESHOLD) {
+                insertionSortRange(arr, left, right);
+                return;
+            }
+            
+            // 枢轴放到left
+            int half = size / 2;
+            if (size > PDQ_NINTHER_THRESHOLD) {
+                sort3(arr, left, left + half, right - 1);
+                sort3(arr, left + 1, left + half - 1, right - 2);
+                sort3(arr, left + 2, left + half + 1, right - 3);
+                sort3(arr, left + half - 1, left + half, left + half + 1);
+                swapBoxes(arr, left, left + half);
+            } else {
+                sort3(arr, left + half, left, right - 1);
+            }
+            
+            bool alreadyPartitioned;
+            int pivotPos = partitionRight(arr, left, right, alreadyPartitioned);
+            int leftSize = pivotPos - left;
+            int rightSize = right - (pivotPos + 1);
+            
+            if (leftSize < size / 8 || rightSize < size / 8) {
+                if (--badAllowed == 0) {
+                    heapSortRange(arr, left, right);
+                    return;
+                }
+                if (leftSize >= PDQ_INSERTION_THRESHOLD) {
+                    swapBoxes(arr, left, left + leftSize / 4);
+                    swapBoxes(arr, pivotPos - 1, pivotPos - leftSize / 4);
+                    if (leftSize > PDQ_NINTHER_THRESHOLD) {
+                        swapBoxes(arr, left + 1, left + leftSize / 4 + 1);
+                        swapBoxes(arr, left + 2, left + leftSize / 4 + 2);
+                        swapBoxes(arr, pivotPos - 2, pivotPos - leftSize / 4 - 1);
+                        swapBoxes(arr, pivotPos - 3, pivotPos - leftSize / 4 - 2);
+                    }
+                }
+                if (rightSize >= PDQ_INSERTION_THRESHOLD) {
+                    swapBoxes(arr, pivotPos + 1, pivotPos + 1 + rightSize / 4);
+                    swapBoxes(arr, right - 1, right - rightSize / 4);
+                    if (rightSize > PDQ_NINTHER_THRESHOLD) {
+                        swapBoxes(arr, pivotPos + 2, pivotPos + 2 + rightSize / 4);
+                        swapBoxes(arr, pivotPos + 3, pivotPos + 3 + rightSize / 4);
+                        swapBoxes(arr, right - 2, right - rightSize / 4 - 1);
+                        swapBoxes(arr, right - 3, right - rightSize / 4 - 2);
+                    }
+                }
+            } else if (alreadyPartitioned && partialInsertionSort(arr, left, pivotPos) &&
+                       partialInsertionSort(arr, pivotPos + 1, right)) {
+                return;
+            }
+            
+            // 左半递归，右半继续循环
+            pdqSortLoop(arr, left, pivotPos, badAllowed);
+            left = pivotPos + 1;
+        }
+    }
+    
+    void pdqSort(vector<BoundingBox>& arr) {
+        int n = arr.size();
+        if (n <= 1) return;
+        int log2n = 0;
+        while ((2 << log2n) <= n) log2n++;
+        pdqSortLoop(arr, 0, n, log2n);
+    }
+    
+    // 11. 自适应排序：先用一遍O(n)扫描统计相邻逆序（下降点）的个数，再按规模和有序程度选择算法。
+    //   已有序 -> 不动；严格逆序 -> 原地反转；不超过ADAPTIVE_SMALL个 -> 插入排序；
+    //   下降点很少 -> pdqSort（划分无交换时的部分插入排序能快速收尾）；
+    //   至少ADAPTIVE_RADIX_MIN个 -> 基数排序；其余 -> pdqSort。
+    // 返回实际采用的做法，便于测试输出
+    const int ADAPTIVE_SMALL = 32;
+    const int ADAPTIVE_RADIX_MIN = 2048;
+    
+    const char* adaptiveSort(vector<BoundingBox>& arr) {
+        int n = arr.size();
+        if (n <= 1) return "已有序";
+        
+        int descents = 0;
+        for (int i = 1; i < n; i++) {
+            if (compareBoxes(arr[i], arr[i - 1])) descents++;
+        }
+        
+        if (descents == 0) return "已有序";
+        if (descents == n - 1) {
+            reverse(arr.begin(), arr.end());
+            NMS_COUNT(CNT_SWAP, n / 2);
+            NMS_COUNT(CNT_BYTES, n / 2 * 3 * sizeof(BoundingBox));
+            return "反转";
+        }
+        if (n <= ADAPTIVE_SMALL) {
+            insertionSortRange(arr, 0, n);
+            return "插入排序";
+        }
+        if (descents <= n / 64 || n < ADAPTIVE_RADIX_MIN) {
+            pdqSort(arr);
+            return "pdqSort";
+        }
+        radixSort(arr);
+        return "基数排序";
+    }
+}
+
+// 计算IoU
+float calculateIoU(const BoundingBox& box1, const BoundingBox& box2) {
+    float interX1 = my_max(box1.x1, box2.x1);
+    float interY1 = my_max(box1.y1, box2.y1);
+    float interX2 = my_min(box1.x2, box2.x2);
+    float interY2 = my_min(box1.y2, box2.y2);
+    
+    NMS_COUNT(CNT_IOU, 1);
+    if (interX2 <= interX1 || interY2 <= interY1) {
+        NMS_COUNT(CNT_EARLY_REJECT, 1);
+        return 0.0f;
+    }
+    
+    float interArea = (interX2 - interX1) * (interY2 - interY1);
+    float unionArea = box1.area() + box2.area() - interArea;
+    
+    if (unionArea <= 0) return 0.0f;
+    return interArea / unionArea;
+}
+
+// ==================== 随机数与数据生成 ====================
+// xoshiro256**生成器：周期2^256-1，用splitmix64把64位种子扩展成256位内部状态
+class RandomEngine {
+private:
+    uint64_t state[4];
+    float spareNormal;
+    bool hasSpare;
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+public:
+    static uint64_t splitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+    explicit RandomEngine(uint64_t seed = 0) {
+        reseed(seed);
+    }
+    
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) state[i] = splitMix64(seed);
+        hasSpare = false;
+    }
+    
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+    
+    // [0,1)均匀分布，取高24位正好填满float尾数
+    float uniform() {
+        return (next() >> 40) * (1.0f / 16777216.0f);
+    }
+    
+    // [0,n)的整数（乘法取高位，避免取模）
+    uint32_t below(uint32_t n) {
+        return (uint32_t)(((next() >> 32) * n) >> 32);
+    }
+    
+    // Box-Muller变换，一次得到两个独立的正态样本，第二个留给下一次调用
+    float normal(float mean, float stddev) {
+        if (hasSpare) {
+            hasSpare = false;
+            return mean + spareNormal * stddev;
+        }
+        float u1 = 1.0f - uniform();  // (0,1]，避免log(0)
+        float u2 = uniform();
+        float r = sqrtf(-2.0f * logf(u1));
+        float theta = 6.2831853f * u2;
+        spareNormal = r * sinf(theta);
+        hasSpare = true;
+        return mean + r * cosf(theta) * stddev;
+    }
+};
+
+// 数据分布编号，与DIST_CODES/DIST_NAMES的下标对应
+enum Distribution {
+    DIST_RANDOM = 0,     // 均匀随机位置和大小
+    DIST_CLUSTERED = 1,  // 围绕10个中心的正态分布
+    DIST_CROWD = 2,      // 密集人群：每个行人有多个高度重叠的检测框
+    DIST_SKEWED = 3,     // 随机位置，置信度集中在低分段（检测器的典型输出）
+    DIST_MIXED = 4       // 尺度跨越两个数量级的混合大小框
+};
+
+const char* DIST_CODES[] = {"random", "clustered", "crowd", "skewed", "mixed"};
+const char* DIST_NAMES[] = {"随机分布", "聚集分布", "密集人群", "置信度偏斜", "混合尺度"};
+const int NUM_DIST_CODES = 5;
+
+// 数据生成器：同一种子下生成的数据完全相同，与线程数和调用顺序无关。
+// 随机流由(种子, 分布, 规模, 用途)决定，例如--sizes=100,1000和--sizes=1000得到相同的1000框数据；
+// 多帧等需要不同数据的场合用purpose区分。流内每CHUNK_SIZE个框使用独立的生成器，因此可以按块并行。
+// 注意sinf/logf等数学库函数在不同平台上可能有末位差异，跨机器比较请用saveBoxes/loadBoxes保存的文件。
+class DataGenerator {
+private:
+    static const int CHUNK_SIZE = 65536;
+    static const int DETECTIONS_PER_PERSON = 8;
+    static uint64_t baseSeed;
+    static const uint64_t CLASS_STREAM = 0x434C415353ULL;  // assignClasses的流，与分布编号区分
+    
+    // 生成框之前需要先确定的场景信息（聚类中心、行人位置）
+    struct Scene {
+        vector<float> centerX, centerY, size;
+    };
+    
+    // 逐个混入各字段，任何一个不同都得到无关的流
+    static uint64_t streamSeed(uint64_t kind, uint64_t size, uint64_t purpose) {
+        uint64_t x = baseSeed;
+        uint64_t fields[3] = {kind, size, purpose};
+        uint64_t h = RandomEngine::splitMix64(x);
+        for (int f = 0; f < 3; f++) {
+            x = h ^ fields[f];
+            h = RandomEngine::splitMix64(x);
+        }
+        return h;
+    }
+    
+    static uint64_t chunkSeed(uint64_t stream, uint64_t chunk) {
+        uint64_t x = stream ^ (chunk * 0xD1B54A32D192ED03ULL);
+        return RandomEngine::splitMix64(x);
+    }
+    
+    static Scene makeScene(Distribution dist, int numBoxes, uint64_t stream) {
+        Scene scene;
+        RandomEngine rng(chunkSeed(stream, 0xFFFFFFFFULL));
+        if (dist == DIST_CLUSTERED) {
+            for (int i = 0; i < 10; i++) {
+                scene.centerX.push_back(rng.uniform());
+                scene.centerY.push_back(rng.uniform());
+            }
+        } else if (dist == DIST_CROWD) {
+            // 行人脚下位置均匀分布，越靠近画面下方越大（透视）
+            int numPeople = (numBoxes + DETECTIONS_PER_PERSON - 1) / DETECTIONS_PER_PERSON;
+            scene.centerX.resize(numPeople);
+            scene.centerY.resize(numPeople);
+            scene.size.resize(numPeople);
+            for (int p = 0; p < numPeople; p++) {
+                float height = 0.04f + 0.12f * rng.uniform();
+                scene.size[p] = height;
+                scene.centerX[p] = rng.uniform() * (1.0f - 0.4f * height) + 0.2f * height;
+                scene.centerY[p] = rng.uniform() * (1.0f - height) + 0.5f * height;
+            }
+        }
+        return scene;
+    }
+    
+    static BoundingBox makeBox(Distribution dist, int i, RandomEngine& rng, const Scene& scene) {
+        float x, y, width, height, confidence;
+        switch (dist) {
+            case DIST_CLUSTERED: {
+                int clusterIdx = i % scene.centerX.size();
+                float centerX = scene.centerX[clusterIdx];
+                float centerY = scene.centerY[clusterIdx];
+                width = height = 0.1f;
+                x = my_max(0.0f, my_min(centerX + rng.normal(0, 0.1f), 1.0f - width));
+                y = my_max(0.0f, my_min(centerY + rng.normal(0, 0.1f), 1.0f - height));
+                // 离中心越远置信度越低
+                float dx = (x + width / 2) - centerX;
+                float dy = (y + height / 2) - centerY;
+                confidence = 0.8f + rng.uniform() * 0.2f - (dx * dx + dy * dy) * 2.0f;
+                break;
+            }
+            case DIST_CROWD: {
+                int person = i / DETECTIONS_PER_PERSON;
+                float size = scene.size[person];
+                height = size * (1.0f + rng.normal(0, 0.08f));
+                width = 0.4f * height * (1.0f + rng.normal(0, 0.08f));
+                x = scene.centerX[person] + rng.normal(0, 0.06f * size) - width / 2;
+                y = scene.centerY[person] + rng.normal(0, 0.06f * size) - height / 2;
+                width = my_max(0.001f, my_min(width, 1.0f));
+                height = my_max(0.001f, my_min(height, 1.0f));
+                x = my_max(0.0f, my_min(x, 1.0f - width));
+                y = my_max(0.0f, my_min(y, 1.0f - height));
+                confidence = rng.normal(0.7f, 0.15f);
+                break;
+            }
+            case DIST_MIXED: {
+                // 边长在[0.005, 0.5]上对数均匀，宽高比在[0.5, 2]上对数均匀
+                float scale = 0.005f * powf(100.0f, rng.uniform());
+                float aspect = sqrtf(powf(4.0f, rng.uniform()) * 0.5f);
+                width = my_min(scale * aspect, 1.0f);
+                height = my_min(scale / aspect, 1.0f);
+                x = rng.uniform() * (1.0f - width);
+                y = rng.uniform() * (1.0f - height);
+                confidence = rng.uniform();
+                break;
+            }
+            default: {
+                width = rng.uniform() * 0.2f + 0.05f;
+                height = rng.uniform() * 0.2f + 0.05f;
+                x = rng.uniform() * (1.0f - width);
+                y = rng.uniform() * (1.0f - height);
+                confidence = rng.uniform();
+                // 偏斜分布：u^4使大部分框落在低分段
+                if (dist == DIST_SKEWED) confidence *= confidence * confidence * confidence;
+                break;
+            }
+        }
+        confidence = my_max(0.01f, my_min(1.0f, confidence));
+        return BoundingBox(i, x, y, width, height, confidence, i);
+    }
+    
+public:
+    static void setSeed(uint64_t seed) {
+        baseSeed = seed;
+    }
+    
+    static uint64_t seed() {
+        return baseSeed;
+    }
+    
+    // 生成numBoxes个框，numThreads>1时按块并行生成，结果与单线程相同。
+    // 相同的(分布, 规模, purpose)总是得到相同的数据
+    static vector<BoundingBox> generate(Distribution dist, int numBoxes, int numThreads = 1, uint64_t purpose = 0) {
+        vector<BoundingBox> boxes(numBoxes);
+        uint64_t stream = streamSeed(dist, numBoxes, purpose);
+        Scene scene = makeScene(dist, numBoxes, stream);
+        
+        int numChunks = (numBoxes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        atomic<int> nextChunk(0);
+        auto worker = [&]() {
+            int c;
+            while ((c = nextChunk.fetch_add(1)) < numChunks) {
+                RandomEngine rng(chunkSeed(stream, c));
+                int end = (int)min<long long>(numBoxes, (long long)(c + 1) * CHUNK_SIZE);
+                for (int i = c * CHUNK_SIZE; i < end; i++) {
+                    boxes[i] = makeBox(dist, i, rng, scene);
+                }
+            }
+        };
+        
+        int workers = min(max(1, numThreads), max(1, numChunks));
+        if (workers == 1) {
+            worker();
+        } else {
+            vector<thread> pool;
+            for (int t = 0; t < workers; t++) pool.push_back(thread(worker));
+            for (int t = 0; t < workers; t++) pool[t].join();
+        }
+        return boxes;
+    }
+    
+    // 随机分布生成
+    static vector<BoundingBox> generateRandomBoxes(int numBoxes) {
+        return generate(DIST_RANDOM, numBoxes);
+    }
+    
+    // 聚集分布生成
+    static vector<BoundingBox> generateClusteredBoxes(int numBoxes) {
+        return generate(DIST_CLUSTERED, numBoxes);
+    }
+    
+    // 为框随机分配类别（多类别检测）
+    static void assignClasses(vector<BoundingBox>& boxes, int numClasses, uint64_t purpose = 0) {
+        RandomEngine rng(chunkSeed(streamSeed(CLASS_STREAM + numClasses, boxes.size(), purpose), 0));
+        for (int i = 0; i < (int)boxes.size(); i++) {
+            boxes[i].classId = rng.below(numClasses);
+        }
+    }
+    
+    // 二进制数据集格式（小端）：8字节魔数"NMSBOXES"，uint32版本号，uint32记录字节数，
+    // uint64框数，之后每个框一条32字节记录：id, originalIndex, classId (int32), x1, y1, x2, y2, confidence (float)
+    static bool saveBoxes(const string& path, const vector<BoundingBox>& boxes) {
+        ofstream out(path.c_str(), ios::binary);
+        if (!out) {
+            cerr << "Error: cannot write " << path << endl;
+            return false;
+        }
+        
+        vector<unsigned char> bytes(24 + boxes.size() * 32);
+        memcpy(&bytes[0], "NMSBOXES", 8);
+        putLittleEndian(&bytes[8], 1, 4);
+        putLittleEndian(&bytes[12], 32, 4);
+        putLittleEndian(&bytes[16], boxes.size(), 8);
+        for (size_t i = 0; i < boxes.size(); i++) {
+            const BoundingBox& box = boxes[i];
+            unsigned char* record = &bytes[24 + i * 32];
+            uint32_t fields[8] = {(uint32_t)box.id, (uint32_t)box.originalIndex, (uint32_t)box.classId,
+                                  floatBits(box.x1), floatBits(box.y1), floatBits(box.x2), floatBits(box.y2),
+                                  floatBits(box.confidence)};
+            for (int f = 0; f < 8; f++) putLittleEndian(record + f * 4, fields[f], 4);
+        }
+        out.write((const char*)bytes.data(), bytes.size());
+        if (!out) {
+            cerr << "Error: failed writing " << path << endl;
+            return false;
+        }
+        return true;
+    }
+    
+    static bool loadBoxes(const string& path, vector<BoundingBox>& boxes) {
+        ifstream in(path.c_str(), ios::binary);
+        if (!in) {
+            cerr << "Error: cannot read " << path << endl;
+            return false;
+        }
+        
+        unsigned char header[24];
+        if (!in.read((char*)header, 24) || memcmp(header, "NMSBOXES", 8) != 0 ||
+            getLittleEndian(header + 8, 4) != 1 || getLittleEndian(header + 12, 4) != 32) {
+            cerr << "Error: " << path << " is not a box dataset file" << endl;
+            return false;
+        }
+        uint64_t count = getLittleEndian(header + 16, 8);
+        if (count > 0x7FFFFFFFULL) {
+            cerr << "Error: " << path << " has too many boxes (" << count << ")" << endl;
+            return false;
+        }
+        
+        vector<unsigned char> bytes(count * 32);
+        if (count > 0 && !in.read((char*)bytes.data(), bytes.size())) {
+            cerr << "Error: " << path << " is truncated" << endl;
+            return false;
+        }
+        
+        boxes.assign(count, BoundingBox());
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* record = &bytes[i * 32];
+            BoundingBox& box = boxes[i];
+            box.id = (int32_t)getLittleEndian(record, 4);
+            box.originalIndex = (int32_t)getLittleEndian(record + 4, 4);
+            box.classId = (int32_t)getLittleEndian(record + 8, 4);
+            box.x1 = bitsFloat(getLittleEndian(record + 12, 4));
+            box.y1 = bitsFloat(getLittleEndian(record + 16, 4));
+            box.x2 = bitsFloat(getLittleEndian(record + 20, 4));
+            box.y2 = bitsFloat(getLittleEndian(record + 24, 4));
+            box.confidence = bitsFloat(getLittleEndian(record + 28, 4));
+        }
+        return true;
+    }
+    
+private:
+    static void putLittleEndian(unsigned char* out, uint64_t value, int numBytes) {
+        for (int b = 0; b < numBytes; b++) out[b] = (unsigned char)(value >> (8 * b));
+    }
+    
+    static uint64_t getLittleEndian(const unsigned char* in, int numBytes) {
+        uint64_t value = 0;
+        for (int b = 0; b < numBytes; b++) value |= (uint64_t)in[b] << (8 * b);
+        return value;
+    }
+    
+    static uint32_t floatBits(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, 4);
+        return bits;
+    }
+    
+    static float bitsFloat(uint64_t bits) {
+        uint32_t narrow = (uint32_t)bits;
+        float value;
+        memcpy(&value, &narrow, 4);
+        return value;
+    }
+};
+
+// 固定默认种子，保证不指定--seed时多次运行使用相同的数据
+uint64_t DataGenerator::baseSeed = 20240601;
+
+// 两组框的字段是否完全相同（keep标记除外）
+bool sameBoxes(const vector<BoundingBox>& a, const vector<BoundingBox>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].id != b[i].id || a[i].originalIndex != b[i].originalIndex || a[i].classId != b[i].classId ||
+            a[i].x1 != b[i].x1 || a[i].y1 != b[i].y1 || a[i].x2 != b[i].x2 || a[i].y2 != b[i].y2 ||
+            a[i].confidence != b[i].confidence) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== 性能测试 ====================
+// 一组重复测量的统计量（毫秒）
+struct TimingStats {
+    double mean;
+    double median;
+    double p95;
+    double p99;
+    double stddev;
+    double min;
+    
+    TimingStats() : mean(0), median(0), p95(0), p99(0), stddev(0), min(0) {}
+};
+
+// 百分位取最近秩（nearest-rank），stddev为样本标准差
+TimingStats computeStats(vector<double> samples) {
+    TimingStats stats;
+    int n = samples.size();
+    if (n == 0) return stats;
+    
+    sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    stats.mean = sum / n;
+    stats.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    stats.p95 = samples[max(0, (int)ceil(0.95 * n) - 1)];
+    stats.p99 = samples[max(0, (int)ceil(0.99 * n) - 1)];
+    stats.min = samples[0];
+    
+    double sq = 0;
+    for (int i = 0; i < n; i++) sq += (samples[i] - stats.mean) * (samples[i] - stats.mean);
+    stats.stddev = n > 1 ? sqrt(sq / (n - 1)) : 0;
+    return stats;
+}
+
+struct PerformanceResult {
+    string sortAlgorithm;
+    string nmsAlgorithm;
+    int sortType;       // runSort中的编号
+    int nmsType;        // runNMS中的编号
+    int sortThreads;
+    int nmsThreads;
+    int numBoxes;
+    string distribution;
+    string distributionKey;   // 命令行中的分布代号（random / clustered ...）
+    double sortTime;    // 以下三项为各次测量的中位数
+    double nmsTime;
+    double totalTime;
+    int remainingBoxes;
+    int repetitions;
+    TimingStats sortStats;
+    TimingStats nmsStats;
+    TimingStats totalStats;
+    PhaseCounters sortCounters;   // 第一次计时测量中各阶段的计数（需要-DNMS_INSTRUMENT）
+    PhaseCounters nmsCounters;
+    
+    PerformanceResult() : sortType(0), nmsType(0), sortThreads(1), nmsThreads(1), numBoxes(0), sortTime(0), nmsTime(0),
+                          totalTime(0), remainingBoxes(0), repetitions(0) {}
+};
+
+// NMS处理函数
+vector<BoundingBox> processNMS(vector<BoundingBox> boxes, float iouThreshold = 0.5f) {
+    vector<BoundingBox> result;
+    
+    for (int i = 0; i < boxes.size(); i++) {
+        if (!boxes[i].keep) continue;
+        
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        
+        for (int j = i + 1; j < boxes.size(); j++) {
+            if (!boxes[j].keep) continue;
+            
+            float iou = calculateIoU(boxes[i], boxes[j]);
+            if (iou > iouThreshold) {
+                boxes[j].keep = false;
+                NMS_COUNT(CNT_SUPPRESS, 1);
+            }
+        }
+    }
+    
+    return result;
+}
+
+// ==================== 空间网格加速NMS ====================
+// 把边界框按坐标划入均匀网格（一个框登记到它覆盖的所有格子），
+// 保留框只需检查与自己共享格子的候选框。IoU>阈值（阈值>=0）要求两框有正面积交集，
+// 而交集中的点必然落在两框都登记过的格子里，所以不会漏掉任何需要抑制的框。
+class SpatialGrid {
+private:
+    float originX, originY;
+    float cellW, cellH;
+    int cols, rows;
+    vector<int> cellStart;   // 每个格子在cellItems中的起始位置（CSR布局）
+    vector<int> cellCount;   // 每个格子中仍然有效的候选框数
+    vector<int> cellItems;   // 格子内的框下标，按排序后的顺序登记
+
+    int cellX(float x) const {
+        int c = (int)((x - originX) / cellW);
+        return c < 0 ? 0 : (c >= cols ? cols - 1 : c);
+    }
+
+    int cellY(float y) const {
+        int c = (int)((y - originY) / cellH);
+        return c < 0 ? 0 : (c >= rows ? rows - 1 : c);
+    }
+
+public:
+    SpatialGrid() : originX(0), originY(0), cellW(1), cellH(1), cols(1), rows(1) {}
+
+    void build(const vector<BoundingBox>& boxes) {
+        int n = boxes.size();
+        float minX = boxes[0].x1, minY = boxes[0].y1;
+        float maxX = boxes[0].x2, maxY = boxes[0].y2;
+        double sumW = 0, sumH = 0;
+        for (int i = 0; i < n; i++) {
+            minX = my_min(minX, boxes[i].x1);
+            minY = my_min(minY, boxes[i].y1);
+            maxX = my_max(maxX, boxes[i].x2);
+            maxY = my_max(maxY, boxes[i].y2);
+            sumW += boxes[i].x2 - boxes[i].x1;
+            sumH += boxes[i].y2 - boxes[i].y1;
+        }
+
+        // 格子边长取平均框尺寸，格子总数限制在约4n以内
+        int maxDim = max(1, (int)(2.0f * sqrtf((float)n)));
+        float rangeX = my_max(maxX - minX, 1e-6f);
+        float rangeY = my_max(maxY - minY, 1e-6f);
+        float avgW = my_max((float)(sumW / n), rangeX / maxDim);
+        float avgH = my_max((float)(sumH / n), rangeY / maxDim);
+        originX = minX;
+        originY = minY;
+        cols = max(1, min(maxDim, (int)ceilf(rangeX / avgW)));
+        rows = max(1, min(maxDim, (int)ceilf(rangeY / avgH)));
+        cellW = rangeX / cols;
+        cellH = rangeY / rows;
+
+        // 计数排序式建表：先统计每个格子的框数，再按前缀和填入
+        int numCells = cols * rows;
+        cellStart.assign(numCells + 1, 0);
+        for (int i = 0; i < n; i++) {
+            int cx1 = cellX(boxes[i].x1), cx2 = cellX(boxes[i].x2);
+            int cy1 = cellY(boxes[i].y1), cy2 = cellY(boxes[i].y2);
+            for (int cy = cy1; cy <= cy2; cy++)
+                for (int cx = cx1; cx <= cx2; cx++)
+                    cellStart[cy * cols + cx + 1]++;
+        }
+        for (int c = 0; c < numCells; c++) {
+            cellStart[c + 1] += cellStart[c];
+        }
+
+        cellCount.assign(numCells, 0);
+        cellItems.resize(cellStart[numCells]);
+        for (int i = 0; i < n; i++) {
+            int cx1 = cellX(boxes[i].x1), cx2 = cellX(boxes[i].x2);
+            int cy1 = cellY(boxes[i].y1), cy2 = cellY(boxes[i].y2);
+            for (int cy = cy1; cy <= cy2; cy++) {
+                for (int cx = cx1; cx <= cx2; cx++) {
+                    int c = cy * cols + cx;
+                    cellItems[cellStart[c] + cellCount[c]++] = i;
+                }
+            }
+        }
+    }
+
+    // 对box i所在格子中排在i之后且仍保留的框调用visit(j)。
+    // 已被抑制或排在i之前的框以后不会再成为候选，顺便从格子里移除。
+    // visited[j]记录最近一次检查j的保留框，避免跨格子的框被重复计算IoU。
+    template<typename Visitor>
+    void visitLaterCandidates(int i, const vector<BoundingBox>& boxes,
+                              vector<int>& visited, Visitor visit) {
+        int cx1 = cellX(boxes[i].x1), cx2 = cellX(boxes[i].x2);
+        int cy1 = cellY(boxes[i].y1), cy2 = cellY(boxes[i].y2);
+        for (int cy = cy1; cy <= cy2; cy++) {
+            for (int cx = cx1; cx <= cx2; cx++) {
+                int c = cy * cols + cx;
+                int* items = &cellItems[cellStart[c]];
+                int k = 0;
+                while (k < cellCount[c]) {
+                    int j = items[k];
+                    if (j <= i || !boxes[j].keep) {
+                        items[k] = items[--cellCount[c]];
+                        continue;
+                    }
+                    if (visited[j] != i) {
+                        visited[j] = i;
+                        visit(j);
+                    }
+                    k++;
+                }
+            }
+        }
+    }
+};
+
+// 网格加速的NMS，保留结果与processNMS完全一致
+vector<BoundingBox> processNMSGrid(vector<BoundingBox> boxes, float iouThreshold = 0.5f) {
+    vector<BoundingBox> result;
+    if (boxes.empty()) return result;
+
+    // 阈值为负时不相交的框也会被抑制；坐标非有限值时无法分格。两种情况都退回原算法
+    if (iouThreshold < 0) return processNMS(boxes, iouThreshold);
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        if (!isfinite(boxes[i].x1) || !isfinite(boxes[i].y1) ||
+            !isfinite(boxes[i].x2) || !isfinite(boxes[i].y2)) {
+            return processNMS(boxes, iouThreshold);
+        }
+    }
+
+    SpatialGrid grid;
+    grid.build(boxes);
+    vector<int> visited(boxes.size(), -1);
+
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        if (!boxes[i].keep) continue;
+
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+
+        grid.visitLaterCandidates(i, boxes, visited, [&](int j) {
+            float iou = calculateIoU(boxes[i], boxes[j]);
+            if (iou > iouThreshold) {
+                boxes[j].keep = false;
+                NMS_COUNT(CNT_SUPPRESS, 1);
+            }
+        });
+    }
+
+    return result;
+}
+
+// ==================== 分数预过滤与扫描线NMS ====================
+// 排序前原地丢弃置信度低于minScore的框（保持原有顺序），返回丢弃的个数
+int filterByScore(vector<BoundingBox>& boxes, float minScore) {
+    int kept = 0;
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        if (boxes[i].confidence >= minScore) {
+            if (kept != i) boxes[kept] = boxes[i];
+            kept++;
+        }
+    }
+    NMS_COUNT(CNT_BYTES, kept * sizeof(BoundingBox));
+    int dropped = boxes.size() - kept;
+    boxes.resize(kept);
+    return dropped;
+}
+
+// 扫描线NMS：另外维护一份按x1排序的活动框列表。保留框i只需检查x1落在
+// (x1_i - 最大框宽, x2_i)内的候选框——x1 >= x2_i或x2 <= x1_i的框在x方向上与i不相交，IoU为0。
+// 已处理（排在i之前）和已被抑制的框在失效项超过一半时从列表中压缩掉。保留结果与processNMS完全一致
+vector<BoundingBox> processNMSSweep(vector<BoundingBox> boxes, float iouThreshold = 0.5f) {
+    vector<BoundingBox> result;
+    int n = boxes.size();
+    if (n == 0) return result;
+    
+    // 与网格NMS相同：负阈值或非有限坐标时退回原算法
+    if (iouThreshold < 0) return processNMS(boxes, iouThreshold);
+    float maxWidth = 0;
+    for (int i = 0; i < n; i++) {
+        if (!isfinite(boxes[i].x1) || !isfinite(boxes[i].x2)) return processNMS(boxes, iouThreshold);
+        maxWidth = my_max(maxWidth, boxes[i].x2 - boxes[i].x1);
+    }
+    
+    // 活动列表：(x1, 下标)按x1升序
+    vector<pair<float, int>> active(n);
+    for (int i = 0; i < n; i++) active[i] = make_pair(boxes[i].x1, i);
+    sort(active.begin(), active.end());
+    NMS_COUNT(CNT_BYTES, n * sizeof(pair<float, int>));
+    int dead = 0;
+    
+    for (int i = 0; i < n; i++) {
+        if (!boxes[i].keep) continue;
+        
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        
+        float left = boxes[i].x1 - maxWidth;
+        float right = boxes[i].x2;
+        vector<pair<float, int>>::iterator it =
+            lower_bound(active.begin(), active.end(), make_pair(left, -1));
+        for (; it != active.end() && it->first < right; ++it) {
+            int j = it->second;
+            if (j <= i || !boxes[j].keep || boxes[j].x2 <= boxes[i].x1) continue;
+            if (calculateIoU(boxes[i], boxes[j]) > iouThreshold) {
+                boxes[j].keep = false;
+                NMS_COUNT(CNT_SUPPRESS, 1);
+                dead++;
+            }
+        }
+        
+        // i本身从此失效；失效项过半时压缩，使后续查找只扫描仍有效的框
+        dead++;
+        if (dead * 2 > (int)active.size()) {
+            int live = 0;
+            for (int k = 0; k < (int)active.size(); k++) {
+                int j = active[k].second;
+                if (j > i && boxes[j].keep) active[live++] = active[k];
+            }
+            active.resize(live);
+            dead = 0;
+        }
+    }
+    
+    return result;
+}
+
+// ==================== SoA存储与SIMD IoU内核 ====================
+// 按列存放的边界框视图：NMS内层循环只需要坐标和面积，按列连续存放后可以一次装入4/8个候选框
+struct BoxColumns {
+    const float* x1;
+    const float* y1;
+    const float* x2;
+    const float* y2;
+    const float* area;
+    int count;
+};
+
+// 拥有数据的SoA容器，由（已排序的）BoundingBox数组构建
+class BoxSoA {
+public:
+    vector<float> x1, y1, x2, y2, area, score;
+    vector<int> id;
+
+    void assign(const vector<BoundingBox>& boxes) {
+        int n = boxes.size();
+        x1.resize(n); y1.resize(n); x2.resize(n); y2.resize(n);
+        area.resize(n); score.resize(n); id.resize(n);
+        for (int i = 0; i < n; i++) {
+            x1[i] = boxes[i].x1;
+            y1[i] = boxes[i].y1;
+            x2[i] = boxes[i].x2;
+            y2[i] = boxes[i].y2;
+            area[i] = boxes[i].area();
+            score[i] = boxes[i].confidence;
+            id[i] = boxes[i].id;
+        }
+    }
+
+    int size() const { return x1.size(); }
+
+    BoxColumns columns() const {
+        BoxColumns c = {x1.data(), y1.data(), x2.data(), y2.data(), area.data(), size()};
+        return c;
+    }
+};
+
+// 与calculateIoU逐步相同的标量计算（面积已预先算好），用作SIMD内核的尾部与回退路径
+inline bool iouExceeds(const BoxColumns& c, int i, int j, float iouThreshold) {
+    float interX1 = my_max(c.x1[i], c.x1[j]);
+    float interY1 = my_max(c.y1[i], c.y1[j]);
+    float interX2 = my_min(c.x2[i], c.x2[j]);
+    float interY2 = my_min(c.y2[i], c.y2[j]);
+
+    float iou = 0.0f;
+    if (interX2 > interX1 && interY2 > interY1) {
+        float interArea = (interX2 - interX1) * (interY2 - interY1);
+        float unionArea = c.area[i] + c.area[j] - interArea;
+        if (unionArea > 0) iou = interArea / unionArea;
+    }
+    return iou > iouThreshold;
+}
+
+const char* simdKernelName() {
+#if defined(__AVX2__)
+    return "AVX2 (8路)";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "SSE2 (4路)";
+#else
+    return "标量";
+#endif
+}
+
+// 一次比较的候选框个数
+#if defined(__AVX2__)
+const int SIMD_WIDTH = 8;
+#elif defined(__SSE2__) || defined(_M_X64)
+const int SIMD_WIDTH = 4;
+#else
+const int SIMD_WIDTH = 1;
+#endif
+
+// 第i个框与[j, j+SIMD_WIDTH)中每个候选框的IoU是否超过阈值，按位返回。
+// 向量路径与iouExceeds做相同顺序的单精度运算，向量路径本身不使用FMA。标量路径则可能在
+// 浮点收缩下被编译器合并成FMA（-ffp-contract=fast是GCC非ISO模式的默认值，目标支持FMA时生效，
+// 如-march=native），这时两边可能相差一次舍入。需要逐位一致时请加-ffp-contract=off编译。
+inline int iouExceedsLanes(const BoxColumns& c, int i, int j, float iouThreshold) {
+#if defined(__AVX2__)
+    __m256 ix1 = _mm256_max_ps(_mm256_set1_ps(c.x1[i]), _mm256_loadu_ps(c.x1 + j));
+    __m256 iy1 = _mm256_max_ps(_mm256_set1_ps(c.y1[i]), _mm256_loadu_ps(c.y1 + j));
+    __m256 ix2 = _mm256_min_ps(_mm256_set1_ps(c.x2[i]), _mm256_loadu_ps(c.x2 + j));
+    __m256 iy2 = _mm256_min_ps(_mm256_set1_ps(c.y2[i]), _mm256_loadu_ps(c.y2 + j));
+    __m256 overlap = _mm256_and_ps(_mm256_cmp_ps(ix2, ix1, _CMP_GT_OQ),
+                                   _mm256_cmp_ps(iy2, iy1, _CMP_GT_OQ));
+    __m256 inter = _mm256_mul_ps(_mm256_sub_ps(ix2, ix1), _mm256_sub_ps(iy2, iy1));
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(_mm256_set1_ps(c.area[i]), _mm256_loadu_ps(c.area + j)), inter);
+    overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(uni, _mm256_setzero_ps(), _CMP_GT_OQ));
+    __m256 iou = _mm256_and_ps(overlap, _mm256_div_ps(inter, uni));
+    return _mm256_movemask_ps(_mm256_cmp_ps(iou, _mm256_set1_ps(iouThreshold), _CMP_GT_OQ));
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 ix1 = _mm_max_ps(_mm_set1_ps(c.x1[i]), _mm_loadu_ps(c.x1 + j));
+    __m128 iy1 = _mm_max_ps(_mm_set1_ps(c.y1[i]), _mm_loadu_ps(c.y1 + j));
+    __m128 ix2 = _mm_min_ps(_mm_set1_ps(c.x2[i]), _mm_loadu_ps(c.x2 + j));
+    __m128 iy2 = _mm_min_ps(_mm_set1_ps(c.y2[i]), _mm_loadu_ps(c.y2 + j));
+    __m128 overlap = _mm_and_ps(_mm_cmpgt_ps(ix2, ix1), _mm_cmpgt_ps(iy2, iy1));
+    __m128 inter = _mm_mul_ps(_mm_sub_ps(ix2, ix1), _mm_sub_ps(iy2, iy1));
+    __m128 uni = _mm_sub_ps(_mm_add_ps(_mm_set1_ps(c.area[i]), _mm_loadu_ps(c.area + j)), inter);
+    overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(uni, _mm_setzero_ps()));
+    __m128 iou = _mm_and_ps(overlap, _mm_div_ps(inter, uni));
+    return _mm_movemask_ps(_mm_cmpgt_ps(iou, _mm_set1_ps(iouThreshold)));
+#else
+    return iouExceeds(c, i, j, iouThreshold) ? 1 : 0;
+#endif
+}
+
+// 用第i个框抑制[begin, end)中IoU超过阈值的框（keep[j]置0）。
+// 已被抑制的框再次置0没有副作用，所以只跳过整组都已抑制的候选框。
+void suppressByBox(const BoxColumns& c, int i, int begin, int end,
+                   float iouThreshold, unsigned char* keep) {
+    int j = begin;
+    for (; j + SIMD_WIDTH <= end; j += SIMD_WIDTH) {
+        if (SIMD_WIDTH == 8) {
+            uint64_t k;
+            memcpy(&k, keep + j, 8);
+            if (k == 0) continue;
+        } else if (SIMD_WIDTH == 4) {
+            uint32_t k;
+            memcpy(&k, keep + j, 4);
+            if (k == 0) continue;
+        } else if (!keep[j]) {
+            continue;
+        }
+
+        int mask = iouExceedsLanes(c, i, j, iouThreshold);
+        NMS_COUNT(CNT_IOU, SIMD_WIDTH);
+        while (mask) {
+            int b = __builtin_ctz(mask);
+            NMS_COUNT(CNT_SUPPRESS, keep[j + b]);
+            keep[j + b] = 0;
+            mask &= mask - 1;
+        }
+    }
+    for (; j < end; j++) {
+        if (!keep[j]) continue;
+        NMS_COUNT(CNT_IOU, 1);
+        if (iouExceeds(c, i, j, iouThreshold)) {
+            keep[j] = 0;
+            NMS_COUNT(CNT_SUPPRESS, 1);
+        }
+    }
+}
+
+// 第i个框对[begin, end)（不超过64个框）的抑制位掩码，第k位对应框begin+k
+uint64_t suppressMask(const BoxColumns& c, int i, int begin, int end, float iouThreshold) {
+    uint64_t mask = 0;
+    int j = begin;
+    for (; j + SIMD_WIDTH <= end; j += SIMD_WIDTH) {
+        mask |= (uint64_t)iouExceedsLanes(c, i, j, iouThreshold) << (j - begin);
+    }
+    NMS_COUNT(CNT_IOU, end - begin);
+    for (; j < end; j++) {
+        if (iouExceeds(c, i, j, iouThreshold)) mask |= 1ULL << (j - begin);
+    }
+    return mask;
+}
+
+// 在已排序的列上执行NMS：keep由调用者提供（至少count个），kept接收保留框的下标，返回保留个数。
+// 不分配内存，可以直接用在映射文件的列上
+int processNMSColumns(const BoxColumns& cols, float iouThreshold, unsigned char* keep, int* kept) {
+    memset(keep, 1, cols.count);
+    int keptCount = 0;
+    for (int i = 0; i < cols.count; i++) {
+        if (!keep[i]) continue;
+        kept[keptCount++] = i;
+        suppressByBox(cols, i, i + 1, cols.count, iouThreshold, keep);
+    }
+    return keptCount;
+}
+
+// 直接在SoA列上执行的NMS，保留结果与processNMS一致
+vector<BoundingBox> processNMSSIMD(const vector<BoundingBox>& boxes, float iouThreshold = 0.5f) {
+    int n = boxes.size();
+    BoxSoA soa;
+    soa.assign(boxes);
+    BoxColumns cols = soa.columns();
+
+    vector<unsigned char> keep(n);
+    for (int i = 0; i < n; i++) {
+        keep[i] = boxes[i].keep ? 1 : 0;
+    }
+
+    vector<BoundingBox> result;
+    for (int i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        suppressByBox(cols, i, i + 1, n, iouThreshold, keep.data());
+    }
+    return result;
+}
+
+// ==================== 定点IoU ====================
+// 坐标是[0, QUANT_MAX]上的整数网格（int16，与特征图坐标一致）。网格坐标可以直接给出；
+// 浮点框按坐标范围extent缩放到网格上，归一化坐标的extent为1。IoU阈值取float的精确值，化成既约分数p/q：
+//   IoU > p/q  <=>  q*inter > p*(areaA + areaB - inter)  <=>  inter*(q+p) > p*(areaA + areaB)
+// 全程整数运算、没有除法。宽高不超过32767，面积小于2^30；p+q小于2^32，两边的乘积都在64位内。
+// 宽高用int16计算，inter由16位乘法的高低两半拼成32位，两边的乘积用mul_epu32展开成64位，
+// 比较看差值的符号位（SSE2没有64位比较）。SSE2一次处理8个候选框，AVX2一次16个。
+const int QUANT_MAX = 32767;
+const int QUANT_MAX_DENOMINATOR_BITS = 31;   // q不超过2^31：阈值不小于2^-8时都能精确表示
+
+inline int16_t quantizeCoordinate(float v, float scale) {
+    long q = lrintf(v * scale);
+    return (int16_t)(q < 0 ? 0 : (q > QUANT_MAX ? QUANT_MAX : q));
+}
+
+// 与BoundingBox并列的定点表示，每个框8字节
+struct QuantizedBox {
+    int16_t x1, y1, x2, y2;
+    
+    QuantizedBox() : x1(0), y1(0), x2(0), y2(0) {}
+    
+    // 网格坐标，应在[0, QUANT_MAX]内
+    QuantizedBox(int16_t left, int16_t top, int16_t right, int16_t bottom)
+        : x1(left), y1(top), x2(right), y2(bottom) {}
+    
+    // 坐标范围为[0, extent]的浮点框
+    QuantizedBox(const BoundingBox& box, float extent) {
+        float scale = QUANT_MAX / extent;
+        x1 = quantizeCoordinate(box.x1, scale);
+        y1 = quantizeCoordinate(box.y1, scale);
+        x2 = quantizeCoordinate(box.x2, scale);
+        y2 = quantizeCoordinate(box.y2, scale);
+    }
+    
+    int32_t area() const {
+        return (int32_t)(x2 - x1) * (y2 - y1);
+    }
+};
+
+// IoU阈值p/q
+struct QuantThreshold {
+    uint32_t p;
+    uint32_t q;
+    
+    double value() const { return (double)p / q; }
+};
+
+// float是m*2^e（m为24位整数），约去公因子2后就是精确的p/q。
+// 阈值不超过0时任何相交都抑制（0/1），不小于1时IoU不可能超过（1/1）；
+// 小于2^-8的阈值分母会超过2^31，这时截掉尾数的低位
+QuantThreshold quantizeThreshold(float t) {
+    QuantThreshold result = {0, 1};
+    if (!(t > 0.0f)) return result;
+    if (t >= 1.0f) {
+        result.p = 1;
+        return result;
+    }
+    int exponent;
+    double fraction = frexp((double)t, &exponent);
+    uint64_t p = (uint64_t)ldexp(fraction, 24);
+    int shift = 24 - exponent;
+    while (shift > 0 && (p & 1) == 0) {
+        p >>= 1;
+        shift--;
+    }
+    while (shift > QUANT_MAX_DENOMINATOR_BITS) {
+        p >>= 1;
+        shift--;
+    }
+    result.p = (uint32_t)p;
+    result.q = 1u << shift;
+    return result;
+}
+
+// 定点内核的列视图：ratioSum是p+q
+struct QuantColumns {
+    const int16_t* x1;
+    const int16_t* y1;
+    const int16_t* x2;
+    const int16_t* y2;
+    const int32_t* area;
+    uint32_t p;
+    uint32_t ratioSum;
+    int count;
+};
+
+// 量化后的SoA容器，每个框12字节（float SoA为20字节，BoundingBox为36字节）
+class QuantizedBoxSoA {
+public:
+    vector<int16_t> x1, y1, x2, y2;
+    vector<int32_t> area;
+    QuantThreshold threshold;
+    
+    void assign(const vector<BoundingBox>& boxes, QuantThreshold t, float extent = 1.0f) {
+        int n = boxes.size();
+        resize(n, t);
+        for (int i = 0; i < n; i++) {
+            set(i, QuantizedBox(boxes[i], extent));
+        }
+    }
+    
+    void assign(const vector<QuantizedBox>& boxes, QuantThreshold t) {
+        int n = boxes.size();
+        resize(n, t);
+        for (int i = 0; i < n; i++) {
+            set(i, boxes[i]);
+        }
+    }
+    
+    int size() const { return x1.size(); }
+    
+    static size_t bytesPerBox() {
+        return 4 * sizeof(int16_t) + sizeof(int32_t);
+    }
+    
+    QuantColumns columns() const {
+        QuantColumns c = {x1.data(), y1.data(), x2.data(), y2.data(), area.data(),
+                          threshold.p, threshold.p + threshold.q, size()};
+        return c;
+    }
+
+private:
+    void resize(int n, QuantThreshold t) {
+        threshold = t;
+        x1.resize(n); y1.resize(n); x2.resize(n); y2.resize(n);
+        area.resize(n);
+    }
+    
+    void set(int i, const QuantizedBox& q) {
+        x1[i] = q.x1;
+        y1[i] = q.y1;
+        x2[i] = q.x2;
+        y2[i] = q.y2;
+        area[i] = q.x2 > q.x1 && q.y2 > q.y1 ? q.area() : 0;
+    }
+};
+
+inline bool quantIoUExceeds(const QuantColumns& c, int i, int j) {
+    int w = (c.x2[i] < c.x2[j] ? c.x2[i] : c.x2[j]) - (c.x1[i] > c.x1[j] ? c.x1[i] : c.x1[j]);
+    int h = (c.y2[i] < c.y2[j] ? c.y2[i] : c.y2[j]) - (c.y1[i] > c.y1[j] ? c.y1[i] : c.y1[j]);
+    if (w <= 0 || h <= 0) return false;
+    return (uint64_t)(w * h) * c.ratioSum > (uint64_t)c.p * (uint32_t)(c.area[i] + c.area[j]);
+}
+
+#if defined(__AVX2__)
+const int QUANT_SIMD_WIDTH = 16;
+#elif defined(__SSE2__) || defined(_M_X64)
+const int QUANT_SIMD_WIDTH = 8;
+#else
+const int QUANT_SIMD_WIDTH = 1;
+#endif
+
+// 把偶数、奇数64位通道的比较位交错回原来的32位通道顺序
+inline int interleaveLaneBits(int even, int odd) {
+    return (even & 1) | (odd & 1) << 1 | (even & 2) << 1 | (odd & 2) << 2;
+}
+
+#if defined(__AVX2__)
+// 8个32位通道的inter*(p+q) > p*areaSum，返回每个128位半区各4位
+inline int quantCompareLanes(__m256i inter, __m256i areaSum, __m256i ratioSum, __m256i p) {
+    __m256i lhsEven = _mm256_mul_epu32(inter, ratioSum);
+    __m256i lhsOdd = _mm256_mul_epu32(_mm256_srli_epi64(inter, 32), ratioSum);
+    __m256i rhsEven = _mm256_mul_epu32(areaSum, p);
+    __m256i rhsOdd = _mm256_mul_epu32(_mm256_srli_epi64(areaSum, 32), p);
+    // 两边都小于2^63，lhs > rhs等价于rhs - lhs为负
+    int even = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sub_epi64(rhsEven, lhsEven)));
+    int odd = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sub_epi64(rhsOdd, lhsOdd)));
+    return interleaveLaneBits(even, odd) | interleaveLaneBits(even >> 2, odd >> 2) << 4;
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+// 4个32位通道的inter*(p+q) > p*areaSum
+inline int quantCompareLanes(__m128i inter, __m128i areaSum, __m128i ratioSum, __m128i p) {
+    __m128i lhsEven = _mm_mul_epu32(inter, ratioSum);
+    __m128i lhsOdd = _mm_mul_epu32(_mm_srli_epi64(inter, 32), ratioSum);
+    __m128i rhsEven = _mm_mul_epu32(areaSum, p);
+    __m128i rhsOdd = _mm_mul_epu32(_mm_srli_epi64(areaSum, 32), p);
+    // 两边都小于2^63，lhs > rhs等价于rhs - lhs为负
+    int even = _mm_movemask_pd(_mm_castsi128_pd(_mm_sub_epi64(rhsEven, lhsEven)));
+    int odd = _mm_movemask_pd(_mm_castsi128_pd(_mm_sub_epi64(rhsOdd, lhsOdd)));
+    return interleaveLaneBits(even, odd);
+}
+#endif
+
+// 第i个框与[j, j+QUANT_SIMD_WIDTH)中每个候选框的判定结果，按位返回。
+// 宽高先截到0：不相交时inter为0，不等式自然不成立，结果与quantIoUExceeds相同
+inline int quantIoUExceedsLanes(const QuantColumns& c, int i, int j) {
+#if defined(__AVX2__)
+    __m256i zero = _mm256_setzero_si256();
+    __m256i ix1 = _mm256_max_epi16(_mm256_set1_epi16(c.x1[i]), _mm256_loadu_si256((const __m256i*)(c.x1 + j)));
+    __m256i iy1 = _mm256_max_epi16(_mm256_set1_epi16(c.y1[i]), _mm256_loadu_si256((const __m256i*)(c.y1 + j)));
+    __m256i ix2 = _mm256_min_epi16(_mm256_set1_epi16(c.x2[i]), _mm256_loadu_si256((const __m256i*)(c.x2 + j)));
+    __m256i iy2 = _mm256_min_epi16(_mm256_set1_epi16(c.y2[i]), _mm256_loadu_si256((const __m256i*)(c.y2 + j)));
+    __m256i w = _mm256_max_epi16(_mm256_sub_epi16(ix2, ix1), zero);
+    __m256i h = _mm256_max_epi16(_mm256_sub_epi16(iy2, iy1), zero);
+    __m256i lo = _mm256_mullo_epi16(w, h);
+    __m256i hi = _mm256_mulhi_epi16(w, h);
+    // 解包在每个128位半区内进行：inter0是第0-3、8-11个框，inter1是第4-7、12-15个框
+    __m256i inter0 = _mm256_unpacklo_epi16(lo, hi);
+    __m256i inter1 = _mm256_unpackhi_epi16(lo, hi);
+    __m256i areaLow = _mm256_loadu_si256((const __m256i*)(c.area + j));
+    __m256i areaHigh = _mm256_loadu_si256((const __m256i*)(c.area + j + 8));
+    __m256i ai = _mm256_set1_epi32(c.area[i]);
+    __m256i sum0 = _mm256_add_epi32(ai, _mm256_permute2x128_si256(areaLow, areaHigh, 0x20));
+    __m256i sum1 = _mm256_add_epi32(ai, _mm256_permute2x128_si256(areaLow, areaHigh, 0x31));
+    __m256i ratioSum = _mm256_set1_epi32((int)c.ratioSum);
+    __m256i p = _mm256_set1_epi32((int)c.p);
+    int m0 = quantCompareLanes(inter0, sum0, ratioSum, p);
+    int m1 = quantCompareLanes(inter1, sum1, ratioSum, p);
+    return (m0 & 0xF) | (m1 & 0xF) << 4 | (m0 & 0xF0) << 4 | (m1 & 0xF0) << 8;
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128i zero = _mm_setzero_si128();
+    __m128i ix1 = _mm_max_epi16(_mm_set1_epi16(c.x1[i]), _mm_loadu_si128((const __m128i*)(c.x1 + j)));
+    __m128i iy1 = _mm_max_epi16(_mm_set1_epi16(c.y1[i]), _mm_loadu_si128((const __m128i*)(c.y1 + j)));
+    __m128i ix2 = _mm_min_epi16(_mm_set1_epi16(c.x2[i]), _mm_loadu_si128((const __m128i*)(c.x2 + j)));
+    __m128i iy2 = _mm_min_epi16(_mm_set1_epi16(c.y2[i]), _mm_loadu_si128((const __m128i*)(c.y2 + j)));
+    __m128i w = _mm_max_epi16(_mm_sub_epi16(ix2, ix1), zero);
+    __m128i h = _mm_max_epi16(_mm_sub_epi16(iy2, iy1), zero);
+    __m128i lo = _mm_mullo_epi16(w, h);
+    __m128i hi = _mm_mulhi_epi16(w, h);
+    __m128i ai = _mm_set1_epi32(c.area[i]);
+    __m128i sum0 = _mm_add_epi32(ai, _mm_loadu_si128((const __m128i*)(c.area + j)));
+    __m128i sum1 = _mm_add_epi32(ai, _mm_loadu_si128((const __m128i*)(c.area + j + 4)));
+    __m128i ratioSum = _mm_set1_epi32((int)c.ratioSum);
+    __m128i p = _mm_set1_epi32((int)c.p);
+    int m0 = quantCompareLanes(_mm_unpacklo_epi16(lo, hi), sum0, ratioSum, p);
+    int m1 = quantCompareLanes(_mm_unpackhi_epi16(lo, hi), sum1, ratioSum, p);
+    return m0 | m1 << 4;
+#else
+    return quantIoUExceeds(c, i, j) ? 1 : 0;
+#endif
+}
+
+// 与suppressByBox相同的抑制循环，只是换成定点内核
+void suppressByQuantBox(const QuantColumns& c, int i, int begin, int end, unsigned char* keep) {
+    int j = begin;
+    for (; j + QUANT_SIMD_WIDTH <= end; j += QUANT_SIMD_WIDTH) {
+        if (QUANT_SIMD_WIDTH >= 8) {
+            uint64_t k[2] = {0, 0};
+            memcpy(k, keep + j, QUANT_SIMD_WIDTH);
+            if ((k[0] | k[1]) == 0) continue;
+        } else if (!keep[j]) {
+            continue;
+        }
+        
+        int mask = quantIoUExceedsLanes(c, i, j);
+        NMS_COUNT(CNT_IOU, QUANT_SIMD_WIDTH);
+        while (mask) {
+            int b = __builtin_ctz(mask);
+            NMS_COUNT(CNT_SUPPRESS, keep[j + b]);
+            keep[j + b] = 0;
+            mask &= mask - 1;
+        }
+    }
+    for (; j < end; j++) {
+        if (!keep[j]) continue;
+        NMS_COUNT(CNT_IOU, 1);
+        if (quantIoUExceeds(c, i, j)) {
+            keep[j] = 0;
+            NMS_COUNT(CNT_SUPPRESS, 1);
+        }
+    }
+}
+
+// 定点NMS：结果等于在网格坐标上、以iouThreshold的精确值计算IoU的NMS。
+// boxes的坐标范围是[0, extent]，归一化坐标取1
+vector<BoundingBox> processNMSQuantized(const vector<BoundingBox>& boxes, float iouThreshold = 0.5f,
+                                        float extent = 1.0f) {
+    int n = boxes.size();
+    QuantizedBoxSoA soa;
+    soa.assign(boxes, quantizeThreshold(iouThreshold), extent);
+    QuantColumns cols = soa.columns();
+    
+    vector<unsigned char> keep(n);
+    for (int i = 0; i < n; i++) {
+        keep[i] = boxes[i].keep ? 1 : 0;
+    }
+    
+    vector<BoundingBox> result;
+    for (int i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        suppressByQuantBox(cols, i, i + 1, n, keep.data());
+    }
+    return result;
+}
+
+// 直接给出网格坐标的定点NMS，boxes已按分数降序排列，返回保留框的下标
+vector<int> processNMSQuantized(const vector<QuantizedBox>& boxes, float iouThreshold = 0.5f) {
+    int n = boxes.size();
+    QuantizedBoxSoA soa;
+    soa.assign(boxes, quantizeThreshold(iouThreshold));
+    QuantColumns cols = soa.columns();
+    
+    vector<unsigned char> keep(n, 1);
+    vector<int> result;
+    for (int i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        result.push_back(i);
+        suppressByQuantBox(cols, i, i + 1, n, keep.data());
+    }
+    return result;
+}
+
+// ==================== 位掩码矩阵并行NMS ====================
+// 工作线程计算上三角的“IoU>阈值”关系：第i行按每64个框一个块打包成uint64掩码，
+// 第b块的第k位表示框i会抑制框b*64+k。随后顺序扫描一遍，用已保留框的掩码累积“已抑制”位图。
+// 为了限制内存，矩阵按行分段（每段tileRows行）计算；段开始时已被抑制的行直接跳过，
+// 全部已被抑制的列块也不再计算——这些掩码不会影响扫描结果。
+// 工作线程在整次调用中只创建一次（TaskPool），每段只是向线程池提交任务并等待。
+vector<BoundingBox> processNMSBitmask(const vector<BoundingBox>& boxes, float iouThreshold = 0.5f,
+                                      int numThreads = 1) {
+    int n = boxes.size();
+    vector<BoundingBox> result;
+    if (n == 0) return result;
+    if (numThreads < 1) numThreads = 1;
+
+    BoxSoA soa;
+    soa.assign(boxes);
+    BoxColumns cols = soa.columns();
+
+    int numBlocks = (n + 63) / 64;
+    vector<uint64_t> removed(numBlocks, 0);
+    for (int i = 0; i < n; i++) {
+        if (!boxes[i].keep) removed[i / 64] |= 1ULL << (i % 64);
+    }
+
+    // 段越短，段内“本会被前面行抑制却仍被计算”的行越少；段长随线程数增长以摊薄每段一次的同步开销
+    int tileRows = 128 * numThreads;
+    TaskPool pool(numThreads);
+    vector<uint64_t> masks((size_t)min(tileRows, n) * numBlocks);
+
+    // 计算[rowBegin, rowEnd)中第t个线程负责的行（交错分配以均衡负载）
+    auto computeRows = [&](int rowBegin, int rowEnd, int t) {
+        for (int i = rowBegin + t; i < rowEnd; i += numThreads) {
+            if (removed[i / 64] >> (i % 64) & 1) continue;
+            uint64_t* row = &masks[(size_t)(i - rowBegin) * numBlocks];
+            for (int b = i / 64; b < numBlocks; b++) {
+                uint64_t word = 0;
+                if (removed[b] != ~0ULL) {
+                    int blockEnd = b * 64 + 64 < n ? b * 64 + 64 : n;
+                    word = suppressMask(cols, i, b * 64, blockEnd, iouThreshold);
+                    // 只保留上三角部分（j > i）
+                    if (b == i / 64) word &= (i % 64 == 63) ? 0 : ~0ULL << (i % 64 + 1);
+                }
+                row[b] = word;
+            }
+        }
+    };
+
+    for (int rowBegin = 0; rowBegin < n; rowBegin += tileRows) {
+        int rowEnd = (int)min<long long>((long long)rowBegin + tileRows, n);
+
+        TaskGroup group(pool);
+        for (int t = 1; t < numThreads; t++) {
+            group.run([&computeRows, rowBegin, rowEnd, t] { computeRows(rowBegin, rowEnd, t); });
+        }
+        computeRows(rowBegin, rowEnd, 0);
+        group.wait();
+
+        // 顺序扫描：未被抑制的行即为保留框，把它的掩码并入已抑制位图
+        for (int i = rowBegin; i < rowEnd; i++) {
+            if (removed[i / 64] >> (i % 64) & 1) continue;
+            result.push_back(boxes[i]);
+            NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+            const uint64_t* row = &masks[(size_t)(i - rowBegin) * numBlocks];
+            for (int b = i / 64; b < numBlocks; b++) {
+                NMS_COUNT(CNT_SUPPRESS, __builtin_popcountll(row[b] & ~removed[b]));
+                removed[b] |= row[b];
+            }
+        }
+    }
+
+    return result;
+}
+
+// ==================== Top-K提前终止NMS ====================
+// 按compareBoxes顺序惰性取出框的最大堆：建堆O(n)，每取一个O(log n)，
+// 只有真正被取出的框才付出排序代价
+class LazyBoxHeap {
+private:
+    const vector<BoundingBox>& boxes;
+    vector<int> heap;   // 存放框下标，避免移动整个BoundingBox
+
+    void siftDown(int i) {
+        int n = heap.size();
+        while (true) {
+            int largest = i;
+            int left = 2 * i + 1;
+            int right = 2 * i + 2;
+            if (left < n && SortAlgorithms::compareBoxes(boxes[heap[left]], boxes[heap[largest]])) {
+                largest = left;
+            }
+            if (right < n && SortAlgorithms::compareBoxes(boxes[heap[right]], boxes[heap[largest]])) {
+                largest = right;
+            }
+            if (largest == i) return;
+            swap(heap[i], heap[largest]);
+            i = largest;
+        }
+    }
+
+public:
+    LazyBoxHeap(const vector<BoundingBox>& b) : boxes(b), heap(b.size()) {
+        for (int i = 0; i < (int)heap.size(); i++) heap[i] = i;
+        for (int i = (int)heap.size() / 2 - 1; i >= 0; i--) siftDown(i);
+    }
+
+    bool empty() const { return heap.empty(); }
+
+    // 取出当前置信度最高的框的下标
+    int pop() {
+        int top = heap[0];
+        heap[0] = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(0);
+        return top;
+    }
+
+    const BoundingBox& box(int index) const { return boxes[index]; }
+};
+
+// 按置信度依次取候选框，只与已保留的框比较，保留满topK个即停止。
+// 贪心NMS中一个框被抑制当且仅当某个排在它前面的保留框与它IoU超过阈值，
+// 所以结果正好是processNMS结果的前topK个。
+vector<BoundingBox> processNMSTopK(LazyBoxHeap& heap, int topK, float iouThreshold = 0.5f) {
+    vector<BoundingBox> result;
+    while ((int)result.size() < topK && !heap.empty()) {
+        const BoundingBox& candidate = heap.box(heap.pop());
+        if (!candidate.keep) continue;
+
+        bool suppressed = false;
+        for (int k = 0; k < (int)result.size(); k++) {
+            if (calculateIoU(result[k], candidate) > iouThreshold) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) result.push_back(candidate);
+    }
+    return result;
+}
+
+vector<BoundingBox> processNMSTopK(const vector<BoundingBox>& boxes, int topK, float iouThreshold = 0.5f) {
+    LazyBoxHeap heap(boxes);
+    return processNMSTopK(heap, topK, iouThreshold);
+}
+
+// ==================== 类别感知NMS与Soft-NMS ====================
+// 类别感知NMS：只有同类别的框之间才互相抑制（顺序参考实现）
+vector<BoundingBox> processNMSClassAware(vector<BoundingBox> boxes, float iouThreshold = 0.5f) {
+    vector<BoundingBox> result;
+    
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        if (!boxes[i].keep) continue;
+        
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        
+        for (int j = i + 1; j < (int)boxes.size(); j++) {
+            if (!boxes[j].keep || boxes[j].classId != boxes[i].classId) continue;
+            
+            float iou = calculateIoU(boxes[i], boxes[j]);
+            if (iou > iouThreshold) {
+                boxes[j].keep = false;
+                NMS_COUNT(CNT_SUPPRESS, 1);
+            }
+        }
+    }
+    
+    return result;
+}
+
+// 分批类别NMS：按类别把（已排序的）框稳定划分成若干组，各组互不影响，
+// 由numThreads个线程并行做SIMD NMS，最后按compareBoxes归并回全局顺序。
+// 结果与processNMSClassAware完全相同。
+vector<BoundingBox> processNMSBatched(const vector<BoundingBox>& boxes, float iouThreshold = 0.5f,
+                                      int numThreads = 1) {
+    // 按类别分组（保持组内原有顺序）
+    map<int, int> classSlot;
+    vector<vector<BoundingBox>> groups;
+    for (int i = 0; i < (int)boxes.size(); i++) {
+        map<int, int>::iterator it = classSlot.find(boxes[i].classId);
+        if (it == classSlot.end()) {
+            it = classSlot.insert(make_pair(boxes[i].classId, (int)groups.size())).first;
+            groups.push_back(vector<BoundingBox>());
+        }
+        groups[it->second].push_back(boxes[i]);
+    }
+
+    int numGroups = groups.size();
+    vector<vector<BoundingBox>> kept(numGroups);
+    atomic<int> nextGroup(0);
+    auto worker = [&]() {
+        int g;
+        while ((g = nextGroup.fetch_add(1)) < numGroups) {
+            kept[g] = processNMSSIMD(groups[g], iouThreshold);
+        }
+    };
+
+    int workers = min(max(1, numThreads), max(1, numGroups));
+    TaskPool pool(workers);
+    TaskGroup group(pool);
+    for (int t = 1; t < workers; t++) group.run(worker);
+    worker();
+    group.wait();
+
+    // 多路归并：堆中是各组当前位置的组号，堆顶是排序最靠前的框，O(n log 组数)
+    vector<int> pos(numGroups, 0);
+    auto later = [&](int a, int b) {
+        return SortAlgorithms::compareBoxes(kept[b][pos[b]], kept[a][pos[a]]);
+    };
+    vector<int> heads;
+    size_t total = 0;
+    for (int g = 0; g < numGroups; g++) {
+        total += kept[g].size();
+        if (!kept[g].empty()) heads.push_back(g);
+    }
+    make_heap(heads.begin(), heads.end(), later);
+
+    vector<BoundingBox> result;
+    result.reserve(total);
+    while (!heads.empty()) {
+        pop_heap(heads.begin(), heads.end(), later);
+        int g = heads.back();
+        result.push_back(kept[g][pos[g]++]);
+        if (pos[g] < (int)kept[g].size()) {
+            push_heap(heads.begin(), heads.end(), later);
+        } else {
+            heads.pop_back();
+        }
+    }
+    return result;
+}
+
+// Soft-NMS衰减方式
+enum SoftNMSMethod {
+    SOFT_LINEAR = 0,    // IoU超过阈值时置信度乘以(1 - IoU)
+    SOFT_GAUSSIAN = 1   // 置信度乘以exp(-IoU^2 / sigma)
+};
+
+// Soft-NMS：不直接删除重叠框，而是按IoU衰减其confidence；
+// 衰减到scoreThreshold以下的框才被丢弃（keep置为false）。
+// 每轮从剩余框中选出当前置信度最高的框，因此返回顺序即选取顺序，confidence为衰减后的值。
+vector<BoundingBox> processSoftNMS(vector<BoundingBox> boxes, int method, float iouThreshold = 0.5f,
+                                   float sigma = 0.5f, float scoreThreshold = 0.001f) {
+    vector<BoundingBox> result;
+    
+    int n = boxes.size();
+    for (int i = 0; i < n; i++) {
+        if (!boxes[i].keep) {
+            swap(boxes[i], boxes[--n]);
+            i--;
+        }
+    }
+    
+    for (int i = 0; i < n; i++) {
+        // 选出剩余框中置信度最高的框
+        int best = i;
+        for (int j = i + 1; j < n; j++) {
+            if (SortAlgorithms::compareBoxes(boxes[j], boxes[best])) best = j;
+        }
+        swap(boxes[i], boxes[best]);
+        result.push_back(boxes[i]);
+        NMS_COUNT(CNT_BYTES, sizeof(BoundingBox));
+        
+        for (int j = i + 1; j < n; j++) {
+            float iou = calculateIoU(boxes[i], boxes[j]);
+            float weight = 1.0f;
+            if (method == SOFT_LINEAR) {
+                if (iou > iouThreshold) weight = 1.0f - iou;
+            } else {
+                weight = expf(-(iou * iou) / sigma);
+            }
+            boxes[j].confidence *= weight;
+            
+            if (boxes[j].confidence < scoreThreshold) {
+                boxes[j].keep = false;
+                NMS_COUNT(CNT_SUPPRESS, 1);
+                swap(boxes[j], boxes[--n]);
+                j--;
+            }
+        }
+    }
+    
+    return result;
+}
+
+// ==================== 流式多帧NMS ====================
+// 流水线中一个槽位的复用缓冲区。容量只在遇到更大的帧时增长，稳定状态下处理一帧不再分配内存
+struct FrameArena {
+    vector<BoundingBox> input;            // submit时复制的输入帧，调用方的缓冲区可以立即复用
+    long long frame;                      // 提交序号
+    vector<SortAlgorithms::KeyIndex> keys;
+    vector<SortAlgorithms::KeyIndex> scratch;
+    vector<int> histogram;
+    vector<float> x1, y1, x2, y2, area;   // 排序后的SoA列
+    vector<int> order;                    // 排序后第k个框在原帧中的下标
+    vector<unsigned char> keep;
+    vector<int> kept;                     // 保留框在原帧中的下标，按NMS顺序
+    int count;
+    int keptCount;
+    
+    FrameArena() : frame(-1), histogram(8 * 256), count(0), keptCount(0) {}
+    
+    void reserve(int n) {
+        if (n <= (int)keys.size()) return;
+        keys.resize(n); scratch.resize(n);
+        x1.resize(n); y1.resize(n); x2.resize(n); y2.resize(n); area.resize(n);
+        order.resize(n); keep.resize(n); kept.resize(n);
+    }
+};
+
+// 多帧NMS流水线：后台线程对第N+1帧做基数排序并整理成SoA列，同时当前线程对第N帧做SIMD抑制。
+// 两个槽位交替使用；每帧的结果是保留框在该帧中的下标，与processNMS对排序后帧的结果一致。
+// 帧可以逐个到达（摄像头等实时输入）：
+//   submit(frame)  复制这一帧并开始后台排序，同时抑制上一次提交的帧
+//   poll(...)      取出上一次submit或flush完成的结果，没有结果时返回false
+//   flush()        等待最后提交的帧并完成抑制（输入结束或需要立即拿到结果时调用）
+// 结果在下一次submit/flush之前有效。processFrames是在此之上对整批帧的封装
+class StreamingNMS {
+private:
+    float iouThreshold;
+    bool pipelined;
+    FrameArena arenas[2];
+    long long submitted;   // 已提交的帧数，也是下一帧的序号
+    int sortingSlot;       // 已开始排序、尚未抑制的槽位，-1表示没有
+    int readySlot;         // 抑制完成、尚未被poll取走的槽位，-1表示没有
+    
+    thread sorter;
+    mutex lock;
+    condition_variable changed;
+    int jobSlot;
+    bool jobPending;
+    bool stopping;
+    
+    void sortFrame(FrameArena& arena) {
+        const BoundingBox* boxes = arena.input.data();
+        int n = arena.input.size();
+        arena.reserve(n);
+        arena.count = n;
+        for (int i = 0; i < n; i++) {
+            arena.keys[i].key = SortAlgorithms::sortKey(boxes[i]);
+            arena.keys[i].index = i;
+        }
+        SortAlgorithms::KeyIndex* sorted = SortAlgorithms::radixSortKeys(
+            arena.keys.data(), arena.scratch.data(), n, arena.histogram.data());
+        
+        for (int k = 0; k < n; k++) {
+            const BoundingBox& box = boxes[sorted[k].index];
+            arena.order[k] = sorted[k].index;
+            arena.x1[k] = box.x1;
+            arena.y1[k] = box.y1;
+            arena.x2[k] = box.x2;
+            arena.y2[k] = box.y2;
+            arena.area[k] = box.area();
+            arena.keep[k] = box.keep ? 1 : 0;
+        }
+    }
+    
+    void suppressFrame(FrameArena& arena) {
+        BoxColumns cols = {arena.x1.data(), arena.y1.data(), arena.x2.data(), arena.y2.data(),
+                           arena.area.data(), arena.count};
+        arena.keptCount = 0;
+        for (int i = 0; i < arena.count; i++) {
+            if (!arena.keep[i]) continue;
+            arena.kept[arena.keptCount++] = arena.order[i];
+            suppressByBox(cols, i, i + 1, arena.count, iouThreshold, arena.keep.data());
+        }
+    }
+    
+    void sorterLoop() {
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            changed.wait(guard, [this] { return jobPending || stopping; });
+            if (stopping) return;
+            guard.unlock();
+            sortFrame(arenas[jobSlot]);
+            guard.lock();
+            jobPending = false;
+            changed.notify_all();
+        }
+    }
+    
+    void startSort(int slot) {
+        if (!pipelined) {
+            sortFrame(arenas[slot]);
+            return;
+        }
+        lock_guard<mutex> guard(lock);
+        jobSlot = slot;
+        jobPending = true;
+        changed.notify_all();
+    }
+    
+    void waitSort() {
+        if (!pipelined) return;
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this] { return !jobPending; });
+    }
+    
+public:
+    StreamingNMS(float threshold = 0.5f, bool usePipeline = true)
+        : iouThreshold(threshold), pipelined(usePipeline), submitted(0), sortingSlot(-1), readySlot(-1),
+          jobSlot(0), jobPending(false), stopping(false) {
+        if (pipelined) sorter = thread(&StreamingNMS::sorterLoop, this);
+    }
+    
+    ~StreamingNMS() {
+        if (!pipelined) return;
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        sorter.join();
+    }
+    
+    // 提交一帧。帧被复制到槽位自己的缓冲区，返回后调用方可以立即改写frame；
+    // 上一次提交的帧在这里完成抑制（与这一帧的排序重叠），之后可以用poll取出
+    void submit(const vector<BoundingBox>& frame) {
+        waitSort();
+        readySlot = -1;
+        int slot = submitted % 2;
+        FrameArena& arena = arenas[slot];
+        arena.input.assign(frame.begin(), frame.end());
+        arena.frame = submitted++;
+        
+        int previous = sortingSlot;
+        sortingSlot = slot;
+        startSort(slot);
+        if (previous != -1) {
+            suppressFrame(arenas[previous]);
+            readySlot = previous;
+        }
+    }
+    
+    // 完成最后提交的帧
+    void flush() {
+        waitSort();
+        if (sortingSlot == -1) return;
+        suppressFrame(arenas[sortingSlot]);
+        readySlot = sortingSlot;
+        sortingSlot = -1;
+    }
+    
+    // 取出已完成的一帧：frame为提交序号（从0开始），kept为保留框在该帧中的下标
+    bool poll(long long& frame, const int*& kept, int& keptCount) {
+        if (readySlot == -1) return false;
+        const FrameArena& arena = arenas[readySlot];
+        frame = arena.frame;
+        kept = arena.kept.data();
+        keptCount = arena.keptCount;
+        readySlot = -1;
+        return true;
+    }
+    
+    // 依次处理frames，每帧完成后调用onFrame(帧号, 保留框下标数组, 保留框数)，帧号是frames中的下标。
+    // 下标数组在下一次回调前有效
+    template<typename FrameCallback>
+    void processFrames(const vector<vector<BoundingBox>>& frames, FrameCallback onFrame) {
+        flush();
+        long long first = submitted;
+        long long frame;
+        const int* kept;
+        int keptCount;
+        for (int f = 0; f < (int)frames.size(); f++) {
+            submit(frames[f]);
+            if (poll(frame, kept, keptCount)) onFrame((int)(frame - first), kept, keptCount);
+        }
+        flush();
+        if (poll(frame, kept, keptCount)) onFrame((int)(frame - first), kept, keptCount);
+    }
+};
+
+// ==================== 映射文件输入 ====================
+// 只读映射整个文件，内容由操作系统按需调入，不经过读取和解析
+class MappedFile {
+private:
+    const unsigned char* base;
+    size_t length;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+    
+public:
+    MappedFile() : base(NULL), length(0) {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+    
+    ~MappedFile() {
+        close();
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+            close();
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+        if (length == 0) return true;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) base = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // 映射建立后不再需要文件描述符
+        if (p != MAP_FAILED) {
+            base = (const unsigned char*)p;
+            madvise(p, length, MADV_SEQUENTIAL);
+        }
+#endif
+        if (base == NULL) {
+            close();
+            return false;
+        }
+        return true;
+    }
+    
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap((void*)base, length);
+#endif
+        base = NULL;
+        length = 0;
+    }
+    
+    const unsigned char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+// 检测结果捕获文件（小端，所有列按64字节对齐）：
+//   128字节文件头（CaptureHeader）
+//   x1, y1, x2, y2, area, score (float) 与 id, classId (int32) 共8列，每列boxCount个值，所有帧首尾相接
+//   可选的帧索引：frameCount+1个uint64，第f帧是第[index[f], index[f+1])个框
+// area在写入时按BoundingBox::area()预先算好，读取端可以把列直接交给SIMD内核。
+// 带CAPTURE_SORTED标记时每帧内已按compareBoxes排好序，读取端无需任何拷贝即可做NMS。
+enum CaptureColumn {
+    CAP_X1 = 0, CAP_Y1, CAP_X2, CAP_Y2, CAP_AREA, CAP_SCORE, CAP_ID, CAP_CLASS, CAPTURE_COLUMNS
+};
+
+const uint32_t CAPTURE_VERSION = 1;
+const uint32_t CAPTURE_SORTED = 1;
+
+struct CaptureHeader {
+    char magic[8];                            // "NMSCAP01"
+    uint32_t version;
+    uint32_t flags;
+    uint64_t boxCount;
+    uint64_t frameCount;
+    uint64_t frameIndexOffset;                // 为0表示没有帧索引，整个文件是一帧
+    uint64_t columnOffset[CAPTURE_COLUMNS];   // 各列起始的字节偏移
+    unsigned char reserved[24];
+};
+static_assert(sizeof(CaptureHeader) == 128, "capture header must be 128 bytes");
+
+// 把若干帧写成捕获文件；sortFrames为true时每帧先按compareBoxes排序并设置CAPTURE_SORTED
+bool writeBoxCapture(const string& path, const vector<vector<BoundingBox>>& frames, bool sortFrames = true) {
+    ofstream out(path.c_str(), ios::binary);
+    if (!out) {
+        cerr << "Error: cannot write " << path << endl;
+        return false;
+    }
+    
+    // 每帧的输出顺序
+    vector<vector<int>> orders(frames.size());
+    uint64_t boxCount = 0;
+    for (int f = 0; f < (int)frames.size(); f++) {
+        int n = frames[f].size();
+        orders[f].resize(n);
+        if (sortFrames) {
+            vector<SortAlgorithms::KeyIndex> keys = SortAlgorithms::makeKeys(frames[f]);
+            vector<SortAlgorithms::KeyIndex> buffer(n);
+            vector<int> histogram(8 * 256);
+            SortAlgorithms::KeyIndex* sorted =
+                SortAlgorithms::radixSortKeys(keys.data(), buffer.data(), n, histogram.data());
+            for (int k = 0; k < n; k++) orders[f][k] = sorted[k].index;
+        } else {
+            for (int k = 0; k < n; k++) orders[f][k] = k;
+        }
+        boxCount += n;
+    }
+    
+    auto align64 = [](uint64_t offset) { return (offset + 63) / 64 * 64; };
+    CaptureHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "NMSCAP01", 8);
+    header.version = CAPTURE_VERSION;
+    header.flags = sortFrames ? CAPTURE_SORTED : 0;
+    header.boxCount = boxCount;
+    header.frameCount = frames.size();
+    uint64_t offset = sizeof(CaptureHeader);
+    for (int c = 0; c < CAPTURE_COLUMNS; c++) {
+        header.columnOffset[c] = offset;
+        offset = align64(offset + boxCount * 4);
+    }
+    header.frameIndexOffset = offset;
+    out.write((const char*)&header, sizeof(header));
+    
+    // 逐列写出，每次缓冲一帧
+    const char padding[64] = {0};
+    vector<uint32_t> column;
+    for (int c = 0; c < CAPTURE_COLUMNS; c++) {
+        for (int f = 0; f < (int)frames.size(); f++) {
+            const vector<BoundingBox>& frame = frames[f];
+            column.resize(frame.size());
+            for (int k = 0; k < (int)frame.size(); k++) {
+                const BoundingBox& box = frame[orders[f][k]];
+                float value = 0;
+                int32_t integer = 0;
+                switch (c) {
+                    case CAP_X1: value = box.x1; break;
+                    case CAP_Y1: value = box.y1; break;
+                    case CAP_X2: value = box.x2; break;
+                    case CAP_Y2: value = box.y2; break;
+                    case CAP_AREA: value = box.area(); break;
+                    case CAP_SCORE: value = box.confidence; break;
+                    case CAP_ID: integer = box.id; break;
+                    default: integer = box.classId; break;
+                }
+                if (c < CAP_ID) memcpy(&column[k], &value, 4);
+                else memcpy(&column[k], &integer, 4);
+            }
+            out.write((const char*)column.data(), column.size() * 4);
+        }
+        out.write(padding, align64(boxCount * 4) - boxCount * 4);
+    }
+    
+    uint64_t begin = 0;
+    out.write((const char*)&begin, 8);
+    for (int f = 0; f < (int)frames.size(); f++) {
+        begin += frames[f].size();
+        out.write((const char*)&begin, 8);
+    }
+    
+    if (!out) {
+        cerr << "Error: failed writing " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+// 捕获文件的只读视图：列指针直接指向映射内存
+class BoxCaptureReader {
+private:
+    MappedFile file;
+    CaptureHeader header;
+    const uint64_t* frameIndex;
+    const float* floatColumn[CAP_ID];
+    const int32_t* idColumn;
+    const int32_t* classColumn;
+    uint64_t singleFrame[2];   // 没有帧索引时使用的[0, boxCount)
+    
+public:
+    BoxCaptureReader() : frameIndex(NULL), idColumn(NULL), classColumn(NULL) {
+        memset(&header, 0, sizeof(header));
+    }
+    
+    // 映射并校验文件，失败时输出错误信息并返回false
+    bool open(const string& path) {
+        uint16_t probe = 1;
+        if (*(const unsigned char*)&probe != 1) {
+            cerr << "Error: capture files require a little-endian host" << endl;
+            return false;
+        }
+        if (!file.open(path)) {
+            cerr << "Error: cannot map " << path << endl;
+            return false;
+        }
+        
+        size_t size = file.size();
+        if (size < sizeof(CaptureHeader) || memcmp(file.data(), "NMSCAP01", 8) != 0) {
+            cerr << "Error: " << path << " is not a capture file" << endl;
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        if (header.version != CAPTURE_VERSION) {
+            cerr << "Error: " << path << " has unsupported version " << header.version << endl;
+            return false;
+        }
+        
+        // 文件头的字段不可信：先与文件大小比较，再做乘法和加法，避免溢出后绕过边界检查
+        if (header.boxCount > size / 4) {
+            cerr << "Error: " << path << " is truncated (box count " << header.boxCount << ")" << endl;
+            return false;
+        }
+        uint64_t columnBytes = header.boxCount * 4;
+        for (int c = 0; c < CAPTURE_COLUMNS; c++) {
+            uint64_t offset = header.columnOffset[c];
+            if (offset % 4 != 0 || offset > size || columnBytes > size - offset) {
+                cerr << "Error: " << path << " is truncated (column " << c << ")" << endl;
+                return false;
+            }
+        }
+        for (int c = 0; c < CAP_ID; c++) {
+            floatColumn[c] = (const float*)(file.data() + header.columnOffset[c]);
+        }
+        idColumn = (const int32_t*)(file.data() + header.columnOffset[CAP_ID]);
+        classColumn = (const int32_t*)(file.data() + header.columnOffset[CAP_CLASS]);
+        
+        if (header.frameIndexOffset == 0) {
+            header.frameCount = 1;
+            singleFrame[0] = 0;
+            singleFrame[1] = header.boxCount;
+            frameIndex = singleFrame;
+        } else {
+            uint64_t offset = header.frameIndexOffset;
+            uint64_t entries = offset <= size ? (size - offset) / 8 : 0;
+            if (offset % 8 != 0 || entries == 0 || header.frameCount > entries - 1) {
+                cerr << "Error: " << path << " is truncated (frame index)" << endl;
+                return false;
+            }
+            frameIndex = (const uint64_t*)(file.data() + offset);
+        }
+        
+        // 每帧必须落在列内，并且能用int下标访问
+        for (uint64_t f = 0; f < header.frameCount; f++) {
+            if (frameIndex[f] > frameIndex[f + 1] || frameIndex[f + 1] > header.boxCount ||
+                frameIndex[f + 1] - frameIndex[f] > 0x7FFFFFFFULL) {
+                cerr << "Error: " << path << " has an invalid frame index at frame " << f << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    uint64_t frameCount() const { return header.frameCount; }
+    uint64_t boxCount() const { return header.boxCount; }
+    bool sorted() const { return header.flags & CAPTURE_SORTED; }
+    size_t fileSize() const { return file.size(); }
+    int frameSize(uint64_t f) const { return (int)(frameIndex[f + 1] - frameIndex[f]); }
+    
+    BoxColumns frameColumns(uint64_t f) const {
+        uint64_t begin = frameIndex[f];
+        BoxColumns cols = {floatColumn[CAP_X1] + begin, floatColumn[CAP_Y1] + begin,
+                           floatColumn[CAP_X2] + begin, floatColumn[CAP_Y2] + begin,
+                           floatColumn[CAP_AREA] + begin, frameSize(f)};
+        return cols;
+    }
+    
+    const float* frameScores(uint64_t f) const { return floatColumn[CAP_SCORE] + frameIndex[f]; }
+    const int32_t* frameIds(uint64_t f) const { return idColumn + frameIndex[f]; }
+    const int32_t* frameClasses(uint64_t f) const { return classColumn + frameIndex[f]; }
+    
+    // 取出单个框（只在需要完整BoundingBox时使用），originalIndex为帧内位置
+    BoundingBox box(uint64_t f, int k) const {
+        BoxColumns cols = frameColumns(f);
+        BoundingBox b(frameIds(f)[k], cols.x1[k], cols.y1[k], 0, 0, frameScores(f)[k], k, frameClasses(f)[k]);
+        b.x2 = cols.x2[k];
+        b.y2 = cols.y2[k];
+        return b;
+    }
+};
+
+// 对捕获文件的每一帧执行NMS，onFrame(帧号, 保留框在该帧中的下标, 保留个数)。
+// 已排序的文件直接在映射的列上计算；未排序的帧先按(score, 帧内位置)基数排序到arena中。
+// arena的缓冲区跨帧复用。
+template<typename FrameCallback>
+void replayCapture(const BoxCaptureReader& reader, FrameArena& arena, float iouThreshold,
+                   FrameCallback onFrame) {
+    for (uint64_t f = 0; f < reader.frameCount(); f++) {
+        int n = reader.frameSize(f);
+        arena.reserve(n);
+        BoxColumns cols = reader.frameColumns(f);
+        
+        if (reader.sorted()) {
+            int keptCount = processNMSColumns(cols, iouThreshold, arena.keep.data(), arena.kept.data());
+            onFrame(f, arena.kept.data(), keptCount);
+            continue;
+        }
+        
+        const float* scores = reader.frameScores(f);
+        for (int i = 0; i < n; i++) {
+            arena.keys[i].key = SortAlgorithms::sortKey(scores[i], i);
+            arena.keys[i].index = i;
+        }
+        SortAlgorithms::KeyIndex* sorted = SortAlgorithms::radixSortKeys(
+            arena.keys.data(), arena.scratch.data(), n, arena.histogram.data());
+        for (int k = 0; k < n; k++) {
+            int idx = sorted[k].index;
+            arena.order[k] = idx;
+            arena.x1[k] = cols.x1[idx];
+            arena.y1[k] = cols.y1[idx];
+            arena.x2[k] = cols.x2[idx];
+            arena.y2[k] = cols.y2[idx];
+            arena.area[k] = cols.area[idx];
+        }
+        BoxColumns sortedCols = {arena.x1.data(), arena.y1.data(), arena.x2.data(), arena.y2.data(),
+                                 arena.area.data(), n};
+        int keptCount = processNMSColumns(sortedCols, iouThreshold, arena.keep.data(), arena.kept.data());
+        for (int k = 0; k < keptCount; k++) arena.kept[k] = arena.order[arena.kept[k]];
+        onFrame(f, arena.kept.data(), keptCount);
+    }
+}
+
+// NMS算法编号
+enum NMSType {
+    NMS_BASELINE = 0,   // 原始O(n^2)扫描
+    NMS_GRID = 1,       // 空间网格加速
+    NMS_SIMD = 2,       // SoA + SIMD IoU内核
+    NMS_BITMASK = 3,    // 位掩码矩阵多线程NMS
+    NMS_TOPK = 4,       // 惰性堆取候选框，保留topK个后提前终止
+    NMS_CLASS_AWARE = 5,    // 类别感知NMS（顺序）
+    NMS_BATCHED = 6,        // 按类别分批并行NMS
+    NMS_SOFT_LINEAR = 7,    // 线性衰减Soft-NMS
+    NMS_SOFT_GAUSSIAN = 8,  // 高斯衰减Soft-NMS
+    NMS_QUANTIZED = 9,      // int16坐标 + 无除法的定点IoU
+    NMS_SWEEP = 10          // 按x1排序的扫描线，跳过x方向不相交的候选框
+};
+
+// runTest的算法参数（NMS类型、阈值、线程数等）
+struct TestOptions {
+    int nmsType;
+    float iouThreshold;
+    int numThreads;     // 仅并行NMS使用
+    int topK;           // 仅Top-K NMS使用
+    int sortThreads;    // 仅并行排序使用
+    float softSigma;        // 高斯Soft-NMS的sigma
+    float scoreThreshold;   // Soft-NMS丢弃框的置信度下限
+    float minScore;         // 排序前丢弃置信度低于此值的框，0表示不过滤
+
+    TestOptions(int type = NMS_BASELINE, int threads = 1)
+        : nmsType(type), iouThreshold(0.5f), numThreads(threads), topK(100), sortThreads(1),
+          softSigma(0.5f), scoreThreshold(0.001f), minScore(0) {}
+};
+
+const char* nmsTypeName(int nmsType) {
+    switch (nmsType) {
+        case NMS_GRID: return "网格NMS";
+        case NMS_SIMD: return "SIMD NMS";
+        case NMS_BITMASK: return "位掩码并行NMS";
+        case NMS_TOPK: return "Top-K NMS";
+        case NMS_CLASS_AWARE: return "类别NMS";
+        case NMS_BATCHED: return "分批类别NMS";
+        case NMS_SOFT_LINEAR: return "线性Soft-NMS";
+        case NMS_SOFT_GAUSSIAN: return "高斯Soft-NMS";
+        case NMS_QUANTIZED: return "定点NMS";
+        case NMS_SWEEP: return "扫描线NMS";
+        default: return "原始NMS";
+    }
+}
+
+vector<BoundingBox> runNMS(const vector<BoundingBox>& boxes, const TestOptions& options) {
+    float t = options.iouThreshold;
+    switch (options.nmsType) {
+        case NMS_GRID: return processNMSGrid(boxes, t);
+        case NMS_SIMD: return processNMSSIMD(boxes, t);
+        case NMS_BITMASK: return processNMSBitmask(boxes, t, options.numThreads);
+        case NMS_TOPK: return processNMSTopK(boxes, options.topK, t);
+        case NMS_CLASS_AWARE: return processNMSClassAware(boxes, t);
+        case NMS_BATCHED: return processNMSBatched(boxes, t, options.numThreads);
+        case NMS_SOFT_LINEAR:
+            return processSoftNMS(boxes, SOFT_LINEAR, t, options.softSigma, options.scoreThreshold);
+        case NMS_SOFT_GAUSSIAN:
+            return processSoftNMS(boxes, SOFT_GAUSSIAN, t, options.softSigma, options.scoreThreshold);
+        case NMS_QUANTIZED: return processNMSQuantized(boxes, t);
+        case NMS_SWEEP: return processNMSSweep(boxes, t);
+        default: return processNMS(boxes, t);
+    }
+}
+
+// 比较两次NMS的保留框序列是否完全相同
+bool sameSurvivors(const vector<BoundingBox>& a, const vector<BoundingBox>& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < (int)a.size(); i++) {
+        if (a[i].id != b[i].id) return false;
+    }
+    return true;
+}
+
+// 按编号调用排序算法（编号与main中的algoNames对应），numThreads只对并行排序有效
+void runSort(vector<BoundingBox>& boxes, int sortType, int numThreads = 1) {
+    switch(sortType) {
+        case 0: SortAlgorithms::quickSort(boxes); break;
+        case 1: SortAlgorithms::mergeSort(boxes); break;
+        case 2: SortAlgorithms::heapSort(boxes); break;
+        case 3: SortAlgorithms::insertionSort(boxes); break;
+        case 4: SortAlgorithms::radixSort(boxes); break;
+        case 5: SortAlgorithms::bucketSort(boxes); break;
+        case 6: SortAlgorithms::indexSort(boxes); break;
+        case 7: SortAlgorithms::parallelQuickSort(boxes, numThreads); break;
+        case 8: SortAlgorithms::parallelMergeSort(boxes, numThreads); break;
+        case 9: SortAlgorithms::pdqSort(boxes); break;
+        case 10: SortAlgorithms::adaptiveSort(boxes); break;
+    }
+}
+
+// 运行测试：先做warmup次不计时的预热，再测量repetitions次，报告中位数与分位数
+PerformanceResult runTest(const vector<BoundingBox>& boxes, int sortType, 
+                         const string& algoName, const string& distName, int repetitions = 3,
+                         const TestOptions& options = TestOptions(), int warmup = 0) {
+    PerformanceResult result;
+    result.sortAlgorithm = algoName;
+    result.nmsAlgorithm = nmsTypeName(options.nmsType);
+    result.nmsThreads = options.numThreads;
+    result.sortThreads = options.sortThreads;
+    result.numBoxes = boxes.size();
+    result.distribution = distName;
+    result.repetitions = repetitions;
+    result.sortType = sortType;
+    result.nmsType = options.nmsType;
+    
+    vector<double> sortSamples, nmsSamples, totalSamples;
+    
+    HighResTimer timer;
+    PerfEventCounters perf;
+    PhaseProbe probe(perf);
+    
+    for (int rep = -warmup; rep < repetitions; rep++) {
+        // 复制原始数据（重置状态）
+        vector<BoundingBox> boxesCopy(boxes);
+        for (int i = 0; i < (int)boxesCopy.size(); i++) {
+            boxesCopy[i].keep = true;
+        }
+        
+        timer.start();
+        
+        // 插桩版本在第一次计时测量的两个阶段外读取计数器
+        bool sample = HOT_PATH_INSTRUMENTED && rep == 0;
+        vector<BoundingBox> remaining;
+        double sortStartTime, sortEndTime, nmsStartTime, nmsEndTime;
+        if (options.nmsType == NMS_TOPK) {
+            // Top-K模式不做完整排序：排序阶段只建堆，NMS阶段边取边抑制
+            if (sample) probe.begin();
+            sortStartTime = timer.elapsedMilliseconds();
+            if (options.minScore > 0) filterByScore(boxesCopy, options.minScore);
+            LazyBoxHeap heap(boxesCopy);
+            sortEndTime = timer.elapsedMilliseconds();
+            if (sample) probe.end(result.sortCounters);
+            
+            if (sample) probe.begin();
+            nmsStartTime = timer.elapsedMilliseconds();
+            remaining = processNMSTopK(heap, options.topK, options.iouThreshold);
+            nmsEndTime = timer.elapsedMilliseconds();
+            if (sample) probe.end(result.nmsCounters);
+        } else {
+            // 排序阶段（包括分数预过滤）
+            if (sample) probe.begin();
+            sortStartTime = timer.elapsedMilliseconds();
+            if (options.minScore > 0) filterByScore(boxesCopy, options.minScore);
+            runSort(boxesCopy, sortType, options.sortThreads);
+            sortEndTime = timer.elapsedMilliseconds();
+            if (sample) probe.end(result.sortCounters);
+            
+            // NMS阶段
+            if (sample) probe.begin();
+            nmsStartTime = timer.elapsedMilliseconds();
+            remaining = runNMS(boxesCopy, options);
+            nmsEndTime = timer.elapsedMilliseconds();
+            if (sample) probe.end(result.nmsCounters);
+        }
+        
+        double endTime = timer.elapsedMilliseconds();
+        
+        if (rep < 0) continue;  // 预热轮不计入统计
+        if (rep == 0) {  // 只记录第一次的保留框数
+            result.remainingBoxes = remaining.size();
+        }
+        
+        sortSamples.push_back(sortEndTime - sortStartTime);
+        nmsSamples.push_back(nmsEndTime - nmsStartTime);
+        totalSamples.push_back(endTime);
+    }
+    
+    result.sortStats = computeStats(sortSamples);
+    result.nmsStats = computeStats(nmsSamples);
+    result.totalStats = computeStats(totalSamples);
+    result.sortTime = result.sortStats.median;
+    result.nmsTime = result.nmsStats.median;
+    result.totalTime = result.totalStats.median;
+    
+    return result;
+}
+
+// 只测排序阶段（NMS在大规模数据上是O(n^2)）：预热、重复和统计方式与runTest相同，
+// 结果只填排序字段，总时间即排序时间。sorted非空时带回最后一次测量的排序结果
+PerformanceResult runSortTest(const vector<BoundingBox>& boxes, int sortType, const string& algoName,
+                              const string& distName, int repetitions = 3, int numThreads = 1, int warmup = 0,
+                              vector<BoundingBox>* sorted = 0) {
+    PerformanceResult result;
+    result.sortAlgorithm = algoName;
+    result.nmsAlgorithm = "";
+    result.sortThreads = numThreads;
+    result.nmsThreads = 0;
+    result.numBoxes = boxes.size();
+    result.distribution = distName;
+    result.repetitions = repetitions;
+    result.sortType = sortType;
+    
+    vector<double> samples;
+    HighResTimer timer;
+    for (int rep = -warmup; rep < repetitions; rep++) {
+        vector<BoundingBox> work(boxes);
+        timer.start();
+        runSort(work, sortType, numThreads);
+        double elapsed = timer.elapsedMilliseconds();
+        
+        if (rep < 0) continue;  // 预热轮不计入统计
+        samples.push_back(elapsed);
+        if (sorted && rep == repetitions - 1) sorted->swap(work);
+    }
+    
+    result.sortStats = computeStats(samples);
+    result.totalStats = result.sortStats;
+    result.sortTime = result.sortStats.median;
+    result.totalTime = result.sortTime;
+    return result;
+}
+
+// ==================== 基准测试配置 ====================
+// 命令行参数可以选择规模、分布、算法、重复次数等；未指定的项沿用默认实验设置
+
+// 命令行中的排序算法代号，下标即runSort中的编号
+const char* SORT_CODES[] = {"quick", "merge", "heap", "insertion", "radix", "bucket", "index",
+                            "pquick", "pmerge", "pdq", "adaptive"};
+const int NUM_SORT_CODES = 11;
+
+struct BenchmarkConfig {
+    vector<int> sizes;
+    vector<string> distributions;
+    vector<int> sortTypes;
+    vector<int> nmsTypes;
+    vector<string> suites;
+    int repetitions;
+    int warmup;
+    int threads;
+    bool pause;
+    string csvPath;      // 非空时把测试矩阵结果写成CSV
+    string jsonPath;     // 非空时把测试矩阵结果写成JSON
+    string comparePath;  // 非空时与该CSV基线比较
+    double regressionThreshold;  // 判为退化的最小相对变慢幅度（百分比）
+    float minScore;      // 测试矩阵中排序前的分数预过滤阈值，0表示不过滤
+    bool customSizes;    // 用户显式指定规模时不再限制聚集分布的规模
+    bool customAlgos;    // 用户显式指定排序算法时不再限制插入排序的规模
+    uint64_t seed;       // 数据生成种子
+    string saveDataDir;  // 非空时把测试矩阵的输入数据保存到该目录
+    string loadDataDir;  // 非空时从该目录读取测试矩阵的输入数据而不是重新生成
+    string capturePath;      // 非空时只对该捕获文件逐帧执行NMS
+    string makeCapturePath;  // 非空时只按规模和分布生成捕获文件
+    int frames;              // 生成捕获文件时每个规模×分布的帧数
+    
+    BenchmarkConfig() : repetitions(5), warmup(1), pause(false), regressionThreshold(5.0), minScore(0),
+                        customSizes(false), customAlgos(false), seed(DataGenerator::seed()),
+                        frames(100) {
+        int defaultSizes[] = {100, 500, 1000, 2000, 5000};
+        sizes.assign(defaultSizes, defaultSizes + 5);
+        distributions.push_back("random");
+        distributions.push_back("clustered");
+        for (int algo = 0; algo < NUM_SORT_CODES; algo++) sortTypes.push_back(algo);
+        nmsTypes.push_back(NMS_BASELINE);
+        suites.push_back("all");
+        threads = max(1, (int)thread::hardware_concurrency());
+    }
+};
+
+int findCode(const char* codes[], int numCodes, const string& name) {
+    for (int i = 0; i < numCodes; i++) {
+        if (name == codes[i]) return i;
+    }
+    return -1;
+}
+
+string distributionName(const string& dist) {
+    int code = findCode(DIST_CODES, NUM_DIST_CODES, dist);
+    return code >= 0 ? DIST_NAMES[code] : "随机分布";
+}
+
+bool isKnownDistribution(const string& dist) {
+    return findCode(DIST_CODES, NUM_DIST_CODES, dist) >= 0;
+}
+
+// 测试矩阵的输入数据：生成（并按需保存），或从--load-data目录读取，读取失败时返回false
+bool prepareBoxes(const BenchmarkConfig& config, const string& dist, int size, vector<BoundingBox>& boxes) {
+    stringstream fileName;
+    fileName << dist << "_" << size << ".bin";
+    if (!config.loadDataDir.empty()) {
+        return DataGenerator::loadBoxes(config.loadDataDir + "/" + fileName.str(), boxes);
+    }
+    
+    boxes = DataGenerator::generate((Distribution)findCode(DIST_CODES, NUM_DIST_CODES, dist), size, config.threads);
+    if (!config.saveDataDir.empty()) {
+        DataGenerator::saveBoxes(config.saveDataDir + "/" + fileName.str(), boxes);
+    }
+    return true;
+}
+
+// 各测试套件的规模：命令行指定了--sizes时用指定的规模，否则用套件自己的默认规模
+vector<int> suiteSizes(const BenchmarkConfig& config, const int* defaults, int count) {
+    if (config.customSizes) return config.sizes;
+    return vector<int>(defaults, defaults + count);
+}
+
+// 线程扩展测试的线程数：1, 2, 4, ...直到config.threads（不是2的幂时最后补上config.threads）
+vector<int> threadSweep(const BenchmarkConfig& config) {
+    vector<int> threadCounts;
+    for (int t = 1; t <= config.threads; t *= 2) threadCounts.push_back(t);
+    if (threadCounts.back() != config.threads) threadCounts.push_back(config.threads);
+    return threadCounts;
+}
+
+string repetitionNote(const BenchmarkConfig& config) {
+    ostringstream out;
+    out << "每项预热" << config.warmup << "次，计时" << config.repetitions << "次取中位数";
+    return out.str();
+}
+
+// 套件输出中的一组测量：中位数和p95（毫秒）
+string timingText(const TimingStats& stats) {
+    ostringstream out;
+    out << fixed << setprecision(3) << stats.median << " ms (p95:" << stats.p95 << ")";
+    return out.str();
+}
+
+// 不经过runTest的测量：body预热config.warmup次、计时config.repetitions次，返回各次耗时（毫秒）的统计量
+TimingStats measureRepeated(const BenchmarkConfig& config, const function<void()>& body) {
+    vector<double> samples;
+    HighResTimer timer;
+    for (int rep = -config.warmup; rep < config.repetitions; rep++) {
+        timer.start();
+        body();
+        double elapsed = timer.elapsedMilliseconds();
+        if (rep >= 0) samples.push_back(elapsed);
+    }
+    return computeStats(samples);
+}
+
+// 大规模数据下比较各NMS引擎与原始NMS（排序统一使用快速排序）
+void runNMSSpeedupTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "        大规模NMS加速测试（相对原始NMS）     \n";
+    cout << "============================================\n";
+    cout << "SIMD内核: " << simdKernelName() << "，" << repetitionNote(config) << "\n";
+
+    int largeSizes[] = {10000, 20000, 50000, 100000};
+    vector<int> sizes = suiteSizes(config, largeSizes, 4);
+    int engines[] = {NMS_GRID, NMS_SIMD};
+    int numEngines = 2;
+
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        int size = sizes[i];
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            string distName = distributionName(config.distributions[d]);
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, config.distributions[d], size, boxes)) continue;
+
+            PerformanceResult base = runTest(boxes, 0, "快速排序", distName, config.repetitions, NMS_BASELINE,
+                                             config.warmup);
+            cout << "  " << setw(7) << size << "个框 " << distName << ": "
+                 << "原始NMS " << timingText(base.nmsStats) << ", "
+                 << "保留" << base.remainingBoxes << "个框\n";
+
+            vector<BoundingBox> sorted = boxes;
+            SortAlgorithms::quickSort(sorted);
+            vector<BoundingBox> expected = processNMS(sorted);
+
+            for (int e = 0; e < numEngines; e++) {
+                PerformanceResult r = runTest(boxes, 0, "快速排序", distName, config.repetitions, engines[e],
+                                              config.warmup);
+
+                // 校验保留的框与原始NMS完全一致
+                bool same = sameSurvivors(expected, runNMS(sorted, TestOptions(engines[e])));
+
+                cout << "      " << left << setw(10) << r.nmsAlgorithm << right
+                     << timingText(r.nmsStats) << ", "
+                     << "加速比 " << fixed << setprecision(2) << base.nmsTime / max(r.nmsTime, 1e-6) << "x"
+                     << (same ? "（结果一致）" : "（结果不一致！）") << "\n";
+            }
+        }
+    }
+}
+
+// 位掩码并行NMS在不同线程数下的扩展性
+void runParallelNMSTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "        位掩码并行NMS线程扩展测试          \n";
+    cout << "============================================\n";
+
+    int hw = thread::hardware_concurrency();
+    cout << "硬件线程数: " << hw << "，" << repetitionNote(config) << "\n";
+    vector<int> threadCounts = threadSweep(config);
+
+    int defaultSizes[] = {20000, 50000, 100000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 3);
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            string distName = distributionName(config.distributions[d]);
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, config.distributions[d], sizes[i], boxes)) continue;
+            vector<BoundingBox> sorted = boxes;
+            SortAlgorithms::quickSort(sorted);
+            vector<BoundingBox> expected = processNMS(sorted);
+            PerformanceResult base = runTest(boxes, 0, "快速排序", distName, config.repetitions, NMS_BASELINE,
+                                             config.warmup);
+
+            cout << "  " << sizes[i] << "个框 " << distName << ": 原始NMS " << timingText(base.nmsStats) << "\n";
+            for (int k = 0; k < (int)threadCounts.size(); k++) {
+                TestOptions options(NMS_BITMASK, threadCounts[k]);
+                PerformanceResult r = runTest(boxes, 0, "快速排序", distName, config.repetitions, options,
+                                              config.warmup);
+                bool same = sameSurvivors(expected, runNMS(sorted, options));
+                cout << "      " << setw(2) << r.nmsThreads << "线程: " << timingText(r.nmsStats) << ", "
+                     << "加速比 " << fixed << setprecision(2) << base.nmsTime / max(r.nmsTime, 1e-6) << "x"
+                     << (same ? "（结果一致）" : "（结果不一致！）") << "\n";
+            }
+        }
+    }
+}
+
+// Top-K NMS与“完整排序+完整NMS”对比（生产只需要前topK个检测结果）
+void runTopKTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "        Top-K提前终止NMS测试（K=100）       \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    TestOptions topK(NMS_TOPK);
+    int defaultSizes[] = {10000, 50000, 100000, 500000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 4);
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            string distName = distributionName(config.distributions[d]);
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, config.distributions[d], sizes[i], boxes)) continue;
+
+            PerformanceResult full = runTest(boxes, 0, "快速排序", distName, config.repetitions, NMS_BASELINE,
+                                             config.warmup);
+            PerformanceResult lazy = runTest(boxes, 0, "惰性堆", distName, config.repetitions, topK, config.warmup);
+
+            // 校验：Top-K结果应等于完整NMS结果的前K个
+            vector<BoundingBox> sorted = boxes;
+            SortAlgorithms::quickSort(sorted);
+            vector<BoundingBox> expected = processNMS(sorted);
+            if ((int)expected.size() > topK.topK) expected.resize(topK.topK);
+            bool same = sameSurvivors(expected, processNMSTopK(boxes, topK.topK));
+
+            cout << "  " << setw(7) << sizes[i] << "个框 " << distName << ": " << fixed << setprecision(3)
+                 << "排序 " << full.sortTime << " -> " << lazy.sortTime << " ms（节省"
+                 << full.sortTime - lazy.sortTime << " ms），"
+                 << "NMS " << full.nmsTime << " -> " << lazy.nmsTime << " ms（节省"
+                 << full.nmsTime - lazy.nmsTime << " ms），"
+                 << "总计 " << timingText(full.totalStats) << " -> " << timingText(lazy.totalStats)
+                 << "，总加速比 " << fixed << setprecision(2)
+                 << full.totalTime / max(lazy.totalTime, 1e-6) << "x"
+                 << (same ? "（结果一致）" : "（结果不一致！）") << "\n";
+        }
+    }
+}
+
+// 多类别场景下比较类别NMS、分批并行NMS和Soft-NMS的吞吐量（20个类别）
+void runMultiClassNMSTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "      多类别NMS与Soft-NMS吞吐量测试         \n";
+    cout << "============================================\n";
+    cout << "分批NMS " << config.threads << "线程，" << repetitionNote(config) << "\n";
+
+    int threads = config.threads;
+    int types[] = {NMS_BASELINE, NMS_CLASS_AWARE, NMS_BATCHED, NMS_SOFT_LINEAR, NMS_SOFT_GAUSSIAN};
+    int defaultSizes[] = {1000, 2000, 5000, 10000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 4);
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            string distName = distributionName(config.distributions[d]);
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, config.distributions[d], sizes[i], boxes)) continue;
+            DataGenerator::assignClasses(boxes, 20);
+
+            vector<BoundingBox> sorted = boxes;
+            SortAlgorithms::quickSort(sorted);
+            bool same = sameSurvivors(processNMSClassAware(sorted), processNMSBatched(sorted, 0.5f, threads));
+
+            cout << "  " << sizes[i] << "个框 " << distName << " 20类"
+                 << (same ? "（分批结果与类别NMS一致）" : "（分批结果与类别NMS不一致！）") << ":\n";
+            for (int k = 0; k < 5; k++) {
+                PerformanceResult r = runTest(boxes, 0, "快速排序", distName, config.repetitions,
+                                              TestOptions(types[k], threads), config.warmup);
+                cout << "      " << left << setw(16) << r.nmsAlgorithm << right
+                     << setw(26) << timingText(r.nmsStats) << ", "
+                     << fixed << setprecision(1) << setw(10) << r.numBoxes / max(r.nmsTime, 1e-6) << " 框/ms, "
+                     << "保留" << r.remainingBoxes << "个框\n";
+            }
+        }
+    }
+}
+
+// 大规模排序阶段对比：直接移动BoundingBox的排序与只移动(键, 下标)的排序
+void runLargeSortTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             大规模排序阶段测试             \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    int sortTypes[] = {0, 1, 4, 5, 6};
+    string sortNames[] = {"快速排序", "归并排序", "基数排序", "桶排序", "索引排序"};
+    int defaultSizes[] = {100000, 1000000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 2);
+
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        vector<BoundingBox> boxes = DataGenerator::generateRandomBoxes(sizes[i]);
+        vector<BoundingBox> expected = boxes;
+        SortAlgorithms::mergeSort(expected);
+
+        cout << "  " << sizes[i] << "个框 随机分布:\n";
+        for (int k = 0; k < 5; k++) {
+            vector<BoundingBox> work;
+            PerformanceResult r = runSortTest(boxes, sortTypes[k], sortNames[k], "随机分布", config.repetitions, 1,
+                                              config.warmup, &work);
+            cout << "      " << sortNames[k] << ": " << timingText(r.sortStats)
+                 << (sameSurvivors(expected, work) ? "" : "（顺序错误！）") << "\n";
+        }
+    }
+}
+
+// 多帧流式NMS：与逐帧“复制+排序+NMS”比较帧率和每帧堆分配次数
+void runStreamingTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             流式多帧NMS测试               \n";
+    cout << "============================================\n";
+
+    cout << repetitionNote(config) << "，帧率和分配次数都取中位数\n";
+
+    int numFrames = 120;
+    int defaultSizes[] = {2000, 10000};
+    vector<int> frameSizes = suiteSizes(config, defaultSizes, 2);
+
+    for (int s = 0; s < (int)frameSizes.size(); s++) {
+        vector<vector<BoundingBox>> frames(numFrames);
+        for (int f = 0; f < numFrames; f++) {
+            frames[f] = DataGenerator::generate(DIST_CLUSTERED, frameSizes[s], 1, f);
+        }
+
+        // 校验：每帧保留的框与processNMS一致。按实时输入的方式逐帧submit，
+        // 摄像头缓冲区提交后立即被改写，结果仍须正确
+        bool same = true;
+        vector<vector<int>> streamed(numFrames);
+        {
+            StreamingNMS checker;
+            vector<BoundingBox> camera;
+            long long frame;
+            const int* kept;
+            int count;
+            auto collect = [&]() {
+                while (checker.poll(frame, kept, count)) {
+                    for (int k = 0; k < count; k++) streamed[frame].push_back(frames[frame][kept[k]].id);
+                }
+            };
+            for (int f = 0; f < numFrames; f++) {
+                camera = frames[f];
+                checker.submit(camera);
+                fill(camera.begin(), camera.end(), BoundingBox());
+                collect();
+            }
+            checker.flush();
+            collect();
+        }
+        for (int f = 0; f < numFrames && same; f++) {
+            vector<BoundingBox> sorted = frames[f];
+            SortAlgorithms::quickSort(sorted);
+            vector<BoundingBox> expected = processNMS(sorted);
+            same = expected.size() == streamed[f].size();
+            for (int k = 0; same && k < (int)expected.size(); k++) same = expected[k].id == streamed[f][k];
+        }
+
+        cout << "  " << numFrames << "帧 × " << frameSizes[s] << "个框 聚集分布"
+             << (same ? "（结果一致）" : "（结果不一致！）") << ":\n";
+
+        // 每次测量记录一遍的分配次数，预热的几遍不计入
+        long long keptTotal = 0;
+        vector<double> allocSamples;
+        auto measureFrames = [&](const function<void()>& pass) {
+            allocSamples.clear();
+            TimingStats stats = measureRepeated(config, [&] {
+                HeapAllocationScope allocations;
+                pass();
+                allocSamples.push_back(allocations.count());
+            });
+            allocSamples.erase(allocSamples.begin(), allocSamples.begin() + config.warmup);
+            return stats;
+        };
+        auto printRate = [&](const char* label, const TimingStats& stats) {
+            cout << "      " << label << ": " << fixed << setprecision(1) << numFrames * 1000.0 / stats.median
+                 << " 帧/秒 (" << timingText(stats) << "), " << setprecision(2)
+                 << computeStats(allocSamples).median / numFrames << " 次分配/帧\n";
+        };
+
+        // 逐帧处理：每帧复制、排序、NMS
+        TimingStats naiveStats = measureFrames([&] {
+            for (int f = 0; f < numFrames; f++) {
+                vector<BoundingBox> work = frames[f];
+                SortAlgorithms::quickSort(work);
+                keptTotal += processNMS(work).size();
+            }
+        });
+        printRate("逐帧处理", naiveStats);
+
+        for (int mode = 0; mode < 2; mode++) {
+            StreamingNMS stream(0.5f, mode == 1);
+            // 先跑一遍让缓冲区增长到最大帧的容量，再测量稳定状态
+            stream.processFrames(frames, [&](int, const int*, int count) { keptTotal += count; });
+
+            TimingStats streamStats = measureFrames([&] {
+                stream.processFrames(frames, [&](int, const int*, int count) { keptTotal += count; });
+            });
+            printRate(mode == 1 ? "流式（流水线）" : "流式（单线程）", streamStats);
+        }
+    }
+}
+
+// 大规模数据生成：各分布生成1000万个框的吞吐量，并检查多线程结果与单线程相同、二进制文件可原样读回
+void runDataGenerationTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             大规模数据生成测试             \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    int defaultSizes[] = {10000000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 1);
+    // 至少用2个线程，单核机器上也走一遍多线程路径以核对结果
+    int threads = max(2, config.threads);
+
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        int numBoxes = sizes[i];
+        cout << "  " << numBoxes << "个框:\n";
+        for (int d = 0; d < NUM_DIST_CODES; d++) {
+            // 相同的分布和规模使用相同的随机流，两次结果可以直接比较
+            vector<BoundingBox> serial, parallel;
+            TimingStats serialStats = measureRepeated(config, [&] {
+                serial = DataGenerator::generate((Distribution)d, numBoxes, 1);
+            });
+            TimingStats parallelStats = measureRepeated(config, [&] {
+                parallel = DataGenerator::generate((Distribution)d, numBoxes, threads);
+            });
+
+            cout << "    " << left << setw(10) << DIST_CODES[d] << right << fixed << setprecision(1)
+                 << " 单线程: " << numBoxes / serialStats.median / 1000.0 << " M框/秒 ("
+                 << timingText(serialStats) << "), " << threads << "线程: " << setprecision(1)
+                 << numBoxes / parallelStats.median / 1000.0 << " M框/秒 (" << timingText(parallelStats) << ")"
+                 << (sameBoxes(serial, parallel) ? "（结果一致）" : "（结果不一致！）") << "\n";
+        }
+    }
+
+    // 生成结果与调用顺序无关：中间插入其他规模、其他分布的生成不影响结果
+    vector<BoundingBox> first = DataGenerator::generate(DIST_RANDOM, 1000);
+    DataGenerator::generate(DIST_RANDOM, 100);
+    DataGenerator::generate(DIST_CROWD, 1000);
+    bool orderFree = sameBoxes(first, DataGenerator::generate(DIST_RANDOM, 1000)) &&
+                     !sameBoxes(first, DataGenerator::generate(DIST_RANDOM, 1000, 1, 1));
+    cout << "  与调用顺序无关: " << (orderFree ? "是" : "否（结果不一致！）") << "\n";
+
+    // 二进制文件往返
+    vector<BoundingBox> boxes = DataGenerator::generate(DIST_MIXED, 1000000, threads);
+    string path = "nms_dataset_roundtrip.bin";
+    vector<BoundingBox> loaded;
+    bool saved = true, ok = true;
+    TimingStats saveStats = measureRepeated(config, [&] { saved = DataGenerator::saveBoxes(path, boxes) && saved; });
+    TimingStats loadStats = measureRepeated(config, [&] { ok = DataGenerator::loadBoxes(path, loaded) && ok; });
+    ok = ok && saved;
+    remove(path.c_str());
+
+    cout << "  二进制文件（100万个框，" << boxes.size() * 32 / 1000000 << " MB）: 写入 "
+         << timingText(saveStats) << ", 读取 " << timingText(loadStats)
+         << (ok && sameBoxes(boxes, loaded) ? "（读回一致）" : "（读回不一致！）") << "\n";
+}
+
+// 捕获文件：写出已排序/未排序的两个文件，映射后逐帧NMS，与读入内存再排序、NMS的做法比较
+void runCaptureTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             映射文件NMS测试               \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    // 帧数沿用--frames（默认100）
+    int numFrames = config.frames;
+    int defaultSizes[] = {5000};
+    vector<int> frameSizes = suiteSizes(config, defaultSizes, 1);
+    vector<vector<BoundingBox>> frames(numFrames);
+    string path = "nms_capture_test.cap";
+
+    for (int s = 0; s < (int)frameSizes.size(); s++) {
+        int frameSize = frameSizes[s];
+        for (int f = 0; f < numFrames; f++) frames[f] = DataGenerator::generate(DIST_CROWD, frameSize, 1, f);
+
+        // 内存中的基准做法：复制、排序、NMS
+        vector<vector<int>> expected(numFrames);
+        TimingStats vectorStats = measureRepeated(config, [&] {
+            for (int f = 0; f < numFrames; f++) {
+                vector<BoundingBox> work = frames[f];
+                SortAlgorithms::quickSort(work);
+                vector<BoundingBox> kept = processNMS(work);
+                expected[f].clear();
+                for (int k = 0; k < (int)kept.size(); k++) expected[f].push_back(kept[k].id);
+            }
+        });
+        cout << "  " << numFrames << "帧 × " << frameSize << "个框 密集人群:\n";
+        cout << "      内存中排序+NMS: " << timingText(vectorStats) << "\n";
+
+        for (int sorted = 1; sorted >= 0; sorted--) {
+            if (!writeBoxCapture(path, frames, sorted == 1)) return;
+
+            // 读取器在删除文件前析构（Windows上不能删除仍被映射的文件）
+            {
+                bool opened = true;
+                TimingStats openStats = measureRepeated(config, [&] {
+                    BoxCaptureReader probe;
+                    opened = probe.open(path) && opened;
+                });
+                BoxCaptureReader reader;
+                if (!opened || !reader.open(path)) break;
+
+                bool same = reader.frameCount() == (uint64_t)numFrames;
+                FrameArena arena;
+                TimingStats replayStats = measureRepeated(config, [&] {
+                    replayCapture(reader, arena, 0.5f, [&](uint64_t f, const int* kept, int count) {
+                        const int32_t* ids = reader.frameIds(f);
+                        same = same && count == (int)expected[f].size();
+                        for (int k = 0; same && k < count; k++) same = ids[kept[k]] == expected[f][k];
+                    });
+                });
+
+                cout << "      " << (sorted ? "已排序文件" : "未排序文件") << " (" << fixed << setprecision(1)
+                     << reader.fileSize() / 1048576.0 << " MB): 映射 " << timingText(openStats) << ", NMS "
+                     << timingText(replayStats) << (same ? "（结果一致）" : "（结果不一致！）") << "\n";
+            }
+            remove(path.c_str());
+        }
+    }
+
+    // 文件头的框数、帧数被改成乘4或加1后会溢出的值时，open必须拒绝而不是越界读取
+    int rejected = 0;
+    for (int k = 0; k < 2; k++) {
+        if (!writeBoxCapture(path, vector<vector<BoundingBox>>(1, frames[0]))) return;
+        {
+            fstream patch(path.c_str(), ios::in | ios::out | ios::binary);
+            CaptureHeader header;
+            patch.read((char*)&header, sizeof(header));
+            if (k == 0) header.boxCount = 1ULL << 62;
+            else header.frameCount = ~0ULL;
+            patch.seekp(0);
+            patch.write((const char*)&header, sizeof(header));
+        }
+        {
+            BoxCaptureReader reader;
+            if (!reader.open(path)) rejected++;
+        }
+        remove(path.c_str());
+    }
+    cout << "      篡改文件头（框数、帧数溢出）: " << (rejected == 2 ? "均被拒绝" : "被接受（结果不一致！）") << "\n";
+}
+
+// 定点IoU：在原始浮点输入上与浮点NMS逐对、逐次核对并报告差异，再比较大规模数据下的吞吐量和内存占用。
+// 归一化坐标要量化到32768级网格，差异只会出现在IoU离阈值不到一个量化误差的框对上；
+// 整数网格坐标（如特征图上的框）直接使用，不经过量化，定点判定是精确的，剩下的差异来自浮点IoU自身的舍入
+void runQuantizedNMSTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             定点IoU NMS测试               \n";
+    cout << "============================================\n";
+
+    // 核对模式
+    vector<BoundingBox> boxes = DataGenerator::generate(DIST_MIXED, 3000);
+    SortAlgorithms::quickSort(boxes);
+    int n = boxes.size();
+    const float GRID_MAX = 4095.0f;
+    vector<BoundingBox> gridBoxes = boxes;
+    vector<QuantizedBox> gridQuant(n);
+    for (int i = 0; i < n; i++) {
+        gridBoxes[i].x1 = rintf(boxes[i].x1 * GRID_MAX);
+        gridBoxes[i].y1 = rintf(boxes[i].y1 * GRID_MAX);
+        gridBoxes[i].x2 = rintf(boxes[i].x2 * GRID_MAX);
+        gridBoxes[i].y2 = rintf(boxes[i].y2 * GRID_MAX);
+        gridQuant[i] = QuantizedBox((int16_t)gridBoxes[i].x1, (int16_t)gridBoxes[i].y1,
+                                    (int16_t)gridBoxes[i].x2, (int16_t)gridBoxes[i].y2);
+    }
+
+    // 两次NMS保留框集合的差异（只在一边出现的框数）
+    auto survivorDiff = [](const vector<BoundingBox>& a, const vector<BoundingBox>& b) {
+        vector<int> idsA, idsB, diff;
+        for (int i = 0; i < (int)a.size(); i++) idsA.push_back(a[i].id);
+        for (int i = 0; i < (int)b.size(); i++) idsB.push_back(b[i].id);
+        sort(idsA.begin(), idsA.end());
+        sort(idsB.begin(), idsB.end());
+        set_symmetric_difference(idsA.begin(), idsA.end(), idsB.begin(), idsB.end(), back_inserter(diff));
+        return (int)diff.size();
+    };
+
+    float thresholds[] = {0.3f, 0.45f, 0.5f, 0.7f};
+    cout << "  核对（" << n << "个混合尺度框，全部" << (long long)n * (n - 1) / 2 << "对，与原始浮点输入比较）:\n";
+    for (int k = 0; k < 4; k++) {
+        float threshold = thresholds[k];
+        QuantThreshold t = quantizeThreshold(threshold);
+        QuantizedBoxSoA quantSoA;
+        quantSoA.assign(boxes, t);
+        QuantColumns quantCols = quantSoA.columns();
+        QuantizedBoxSoA gridSoA;
+        gridSoA.assign(gridQuant, t);
+        QuantColumns gridCols = gridSoA.columns();
+
+        long long mismatches = 0, gridMismatches = 0;
+        double worstGap = 0.0;
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                float iou = calculateIoU(boxes[i], boxes[j]);
+                if ((iou > threshold) != quantIoUExceeds(quantCols, i, j)) {
+                    mismatches++;
+                    worstGap = max(worstGap, fabs((double)iou - threshold));
+                }
+                if ((calculateIoU(gridBoxes[i], gridBoxes[j]) > threshold) != quantIoUExceeds(gridCols, i, j)) {
+                    gridMismatches++;
+                }
+            }
+        }
+        // 向量内核与标量定点判定逐位一致
+        long long laneMismatches = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j + QUANT_SIMD_WIDTH <= n; j += QUANT_SIMD_WIDTH) {
+                int mask = quantIoUExceedsLanes(quantCols, i, j);
+                for (int b = 0; b < QUANT_SIMD_WIDTH; b++) {
+                    if (((mask >> b) & 1) != (int)quantIoUExceeds(quantCols, i, j + b)) laneMismatches++;
+                }
+            }
+        }
+        int nmsDiff = survivorDiff(processNMS(boxes, threshold), processNMSQuantized(boxes, threshold));
+        vector<int> gridKeptIndex = processNMSQuantized(gridQuant, threshold);
+        vector<BoundingBox> gridKept;
+        for (int i = 0; i < (int)gridKeptIndex.size(); i++) gridKept.push_back(gridBoxes[gridKeptIndex[i]]);
+        int gridNmsDiff = survivorDiff(processNMS(gridBoxes, threshold), gridKept);
+
+        cout << "    阈值" << fixed << setprecision(2) << threshold << " = " << t.p << "/" << t.q << ":\n"
+             << "      归一化坐标: " << mismatches << "对与浮点判定不同";
+        if (mismatches > 0) cout << "（IoU与阈值最多相差" << scientific << setprecision(1) << worstGap << fixed << "）";
+        cout << ", NMS保留框差异" << nmsDiff << "个\n"
+             << "      网格坐标: " << gridMismatches << "对与浮点判定不同, NMS保留框"
+             << (gridNmsDiff == 0 ? "一致" : "差异" + to_string(gridNmsDiff) + "个") << "\n"
+             << "      向量内核与标量定点判定" << (laneMismatches == 0 ? "一致" : "不一致！") << "\n";
+    }
+
+    // 吞吐量与内存占用
+    cout << "  每框内存: BoundingBox " << sizeof(BoundingBox) << "字节, 浮点SoA " << 5 * sizeof(float)
+         << "字节, 定点SoA " << QuantizedBoxSoA::bytesPerBox() << "字节\n";
+    cout << "  " << repetitionNote(config) << "\n";
+    int defaultSizes[] = {20000, 50000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 2);
+    for (int s = 0; s < (int)sizes.size(); s++) {
+        int n = sizes[s];
+        vector<BoundingBox> data = DataGenerator::generate(DIST_RANDOM, n);
+        SortAlgorithms::quickSort(data);
+
+        vector<BoundingBox> floatKept, quantKept;
+        TimingStats floatStats = measureRepeated(config, [&] { floatKept = processNMSSIMD(data, 0.5f); });
+        TimingStats quantStats = measureRepeated(config, [&] { quantKept = processNMSQuantized(data, 0.5f); });
+
+        // 内核吞吐量：前1000个框与所有框的判定，不跳过已抑制的框
+        BoxSoA fs;
+        fs.assign(data);
+        BoxColumns fc = fs.columns();
+        QuantizedBoxSoA qs;
+        qs.assign(data, quantizeThreshold(0.5f));
+        QuantColumns qc = qs.columns();
+        int rows = min(1000, n);
+        long long floatHits = 0, quantHits = 0;
+        TimingStats floatKernel = measureRepeated(config, [&] {
+            floatHits = 0;
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j + SIMD_WIDTH <= n; j += SIMD_WIDTH) floatHits += __builtin_popcount(iouExceedsLanes(fc, i, j, 0.5f));
+            }
+        });
+        TimingStats quantKernel = measureRepeated(config, [&] {
+            quantHits = 0;
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j + QUANT_SIMD_WIDTH <= n; j += QUANT_SIMD_WIDTH) quantHits += __builtin_popcount(quantIoUExceedsLanes(qc, i, j));
+            }
+        });
+        double pairs = (double)rows * n;
+
+        cout << "  " << n << "个随机框: 浮点SIMD NMS " << timingText(floatStats) << "（保留"
+             << floatKept.size() << "）, 定点NMS " << timingText(quantStats) << "（保留" << quantKept.size() << "）\n"
+             << "      IoU判定吞吐量: 浮点" << SIMD_WIDTH << "路 " << setprecision(1) << pairs / floatKernel.median / 1000.0
+             << " M对/秒, 定点" << QUANT_SIMD_WIDTH << "路 " << pairs / quantKernel.median / 1000.0 << " M对/秒"
+             << "（超过阈值: 浮点" << floatHits << "对, 定点" << quantHits << "对）\n";
+    }
+}
+
+// 分数预过滤与扫描线NMS：在--dists指定的各分布上与原始NMS、网格NMS比较
+void runSweepNMSTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "         分数预过滤与扫描线NMS测试         \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    int defaultSizes[] = {1000, 5000, 20000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 3);
+    int engines[] = {NMS_BASELINE, NMS_GRID, NMS_SWEEP};
+    for (int d = 0; d < (int)config.distributions.size(); d++) {
+        string distName = distributionName(config.distributions[d]);
+        for (int s = 0; s < (int)sizes.size(); s++) {
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, config.distributions[d], sizes[s], boxes)) continue;
+            cout << "  " << distName << " " << sizes[s] << "个框:\n";
+
+            PerformanceResult base;
+            for (int e = 0; e < 3; e++) {
+                PerformanceResult r = runTest(boxes, 4, "基数排序", distName, config.repetitions, engines[e],
+                                              config.warmup);
+                if (e == 0) base = r;
+                cout << "      " << r.nmsAlgorithm << ": NMS " << timingText(r.nmsStats)
+                     << " (加速 " << fixed << setprecision(2) << base.nmsTime / max(r.nmsTime, 1e-6)
+                     << "x), 保留" << r.remainingBoxes << "个框\n";
+            }
+
+            // 预过滤：丢弃置信度低于阈值的框后再排序和扫描线NMS
+            float minScores[] = {0.3f, 0.5f};
+            for (int m = 0; m < 2; m++) {
+                TestOptions options(NMS_SWEEP);
+                options.minScore = minScores[m];
+                PerformanceResult r = runTest(boxes, 4, "基数排序", distName, config.repetitions, options,
+                                              config.warmup);
+                cout << "      预过滤" << setprecision(1) << minScores[m] << "+扫描线: 总计 "
+                     << timingText(r.totalStats) << " (无过滤原始NMS " << timingText(base.totalStats) << "), 保留"
+                     << r.remainingBoxes << "个框\n";
+            }
+        }
+    }
+
+    // 扫描线NMS在各种输入上与原始NMS一致
+    bool same = true;
+    for (int d = 0; d < NUM_DIST_CODES && same; d++) {
+        for (int k = 0; k < 3 && same; k++) {
+            vector<BoundingBox> boxes = DataGenerator::generate((Distribution)d, 2000);
+            SortAlgorithms::quickSort(boxes);
+            float t = 0.3f + 0.2f * k;
+            same = sameSurvivors(processNMS(boxes, t), processNMSSweep(boxes, t));
+        }
+    }
+    cout << "  所有分布、阈值0.3/0.5/0.7下扫描线NMS与原始NMS" << (same ? "结果一致" : "结果不一致！") << "\n";
+}
+
+// 检查是否已按compareBoxes排好序
+bool isSortedBoxes(const vector<BoundingBox>& boxes) {
+    for (int i = 1; i < (int)boxes.size(); i++) {
+        if (SortAlgorithms::compareBoxes(boxes[i], boxes[i - 1])) return false;
+    }
+    return true;
+}
+
+// 并行排序在1到N个线程下的扩展性
+void runParallelSortTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             并行排序线程扩展测试           \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    vector<int> threadCounts = threadSweep(config);
+
+    int sortTypes[] = {7, 8};
+    string sortNames[] = {"并行快速排序", "并行归并排序"};
+    int defaultSizes[] = {100000, 1000000, 10000000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 3);
+
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        vector<BoundingBox> boxes = DataGenerator::generateRandomBoxes(sizes[i]);
+        cout << "  " << sizes[i] << "个框 随机分布:\n";
+        for (int k = 0; k < 2; k++) {
+            double oneThread = 0;
+            for (int t = 0; t < (int)threadCounts.size(); t++) {
+                vector<BoundingBox> work;
+                PerformanceResult r = runSortTest(boxes, sortTypes[k], sortNames[k], "随机分布", config.repetitions,
+                                                  threadCounts[t], config.warmup, &work);
+                if (t == 0) oneThread = r.sortTime;
+
+                cout << "      " << r.sortAlgorithm << " " << setw(2) << r.sortThreads << "线程: "
+                     << timingText(r.sortStats) << ", 加速比 " << fixed << setprecision(2)
+                     << oneThread / max(r.sortTime, 1e-6) << "x"
+                     << (isSortedBoxes(work) ? "" : "（顺序错误！）") << "\n";
+            }
+        }
+    }
+}
+
+// 不同输入模式下的排序：随机、已有序、逆序、大量重复分数、风琴管（先升后降）。
+// 快速排序用中间元素作枢轴，风琴管这类输入会退化，只在小规模上运行
+enum SortPattern { PATTERN_RANDOM, PATTERN_SORTED, PATTERN_REVERSED, PATTERN_DUPLICATES, PATTERN_ORGAN_PIPE,
+                   NUM_SORT_PATTERNS };
+const char* SORT_PATTERN_NAMES[] = {"随机", "已有序", "逆序", "大量重复分数", "风琴管"};
+
+vector<BoundingBox> makePatternBoxes(SortPattern pattern, int n) {
+    vector<BoundingBox> boxes = DataGenerator::generateRandomBoxes(n);
+    if (pattern == PATTERN_DUPLICATES) {
+        // 只有10种分数，排序主要靠原始索引区分
+        for (int i = 0; i < n; i++) boxes[i].confidence = floor(boxes[i].confidence * 10) / 10;
+        return boxes;
+    }
+    if (pattern == PATTERN_RANDOM) return boxes;
+
+    SortAlgorithms::mergeSort(boxes);
+    if (pattern == PATTERN_REVERSED) {
+        reverse(boxes.begin(), boxes.end());
+    } else if (pattern == PATTERN_ORGAN_PIPE) {
+        // 偶数位置的框按顺序排在前半，奇数位置的框倒序排在后半
+        vector<BoundingBox> pipe;
+        pipe.reserve(n);
+        for (int i = 0; i < n; i += 2) pipe.push_back(boxes[i]);
+        for (int i = n - 1 - (n % 2 == 0 ? 0 : 1); i > 0; i -= 2) pipe.push_back(boxes[i]);
+        boxes.swap(pipe);
+    }
+    return boxes;
+}
+
+void runSortPatternTest(const BenchmarkConfig& config) {
+    cout << "\n============================================\n";
+    cout << "             排序输入模式测试               \n";
+    cout << "============================================\n";
+    cout << repetitionNote(config) << "\n";
+
+    int sortTypes[] = {0, 1, 2, 4, 9, 10};
+    string sortNames[] = {"快速排序", "归并排序", "堆排序", "基数排序", "pdqSort", "自适应排序"};
+    const int QUICK_SORT_MAX = 20000;
+    int defaultSizes[] = {10000, 1000000};
+    vector<int> sizes = suiteSizes(config, defaultSizes, 2);
+
+    for (int i = 0; i < (int)sizes.size(); i++) {
+        cout << "  " << sizes[i] << "个框:\n";
+        for (int p = 0; p < NUM_SORT_PATTERNS; p++) {
+            vector<BoundingBox> boxes = makePatternBoxes((SortPattern)p, sizes[i]);
+            vector<BoundingBox> expected = boxes;
+            SortAlgorithms::mergeSort(expected);
+
+            cout << "    " << SORT_PATTERN_NAMES[p] << ":";
+            for (int k = 0; k < 6; k++) {
+                if (sortTypes[k] == 0 && sizes[i] > QUICK_SORT_MAX && p != PATTERN_RANDOM) {
+                    cout << " " << sortNames[k] << " 跳过";
+                    continue;
+                }
+                vector<BoundingBox> work;
+                PerformanceResult r = runSortTest(boxes, sortTypes[k], sortNames[k], SORT_PATTERN_NAMES[p],
+                                                  config.repetitions, 1, config.warmup, &work);
+                cout << " " << sortNames[k] << " " << fixed << setprecision(3) << r.sortTime << "ms";
+                if (sortTypes[k] == 10) {
+                    // 自适应排序选了哪条路径（不计时）
+                    vector<BoundingBox> probe = boxes;
+                    cout << "（" << SortAlgorithms::adaptiveSort(probe) << "）";
+                }
+                if (!sameSurvivors(expected, work) || !isSortedBoxes(work)) cout << "（顺序错误！）";
+            }
+            cout << "\n";
+        }
+    }
+}
+
+// 命令行中的NMS算法代号，下标即runNMS中的编号
+const char* NMS_CODES[] = {"baseline", "grid", "simd", "bitmask", "topk", "class", "batched",
+                           "soft-linear", "soft-gaussian", "quant", "sweep"};
+const int NUM_NMS_CODES = 11;
+const char* SUITE_CODES[] = {"matrix", "speedup", "parallel-nms", "topk", "multiclass", "sort",
+                             "parallel-sort", "stream", "datagen", "capture", "quant",
+                             "sweep", "sort-patterns"};
+const int NUM_SUITE_CODES = 13;
+
+string sortCode(int sortType) {
+    return sortType >= 0 && sortType < NUM_SORT_CODES ? SORT_CODES[sortType] : "unknown";
+}
+
+string nmsCode(int nmsType) {
+    return nmsType >= 0 && nmsType < NUM_NMS_CODES ? NMS_CODES[nmsType] : "unknown";
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+void printUsage(const char* program) {
+    cout << "用法: " << program << " [选项]\n"
+         << "  --sizes=100,1000,...     测试规模（默认100,500,1000,2000,5000）\n"
+         << "  --dists=random,...       数据分布: ";
+    for (int i = 0; i < NUM_DIST_CODES; i++) cout << DIST_CODES[i] << (i + 1 < NUM_DIST_CODES ? "," : "\n");
+    cout
+         << "  --algos=quick,merge,...  排序算法: ";
+    for (int i = 0; i < NUM_SORT_CODES; i++) cout << SORT_CODES[i] << (i + 1 < NUM_SORT_CODES ? "," : "\n");
+    cout << "  --nms=baseline,...       NMS算法: ";
+    for (int i = 0; i < NUM_NMS_CODES; i++) cout << NMS_CODES[i] << (i + 1 < NUM_NMS_CODES ? "," : "\n");
+    cout << "  --suites=all|none|...    额外测试: ";
+    for (int i = 0; i < NUM_SUITE_CODES; i++) cout << SUITE_CODES[i] << (i + 1 < NUM_SUITE_CODES ? "," : "\n");
+    cout << "  --reps=N                 每个测试的计时次数（默认5），对测试矩阵和额外测试都有效\n"
+         << "  --warmup=N               每个测试的预热次数（默认1）\n"
+         << "  --threads=N              并行排序/NMS的线程数，线程扩展测试从1测到N（默认硬件线程数）\n"
+         << "  --csv=FILE               把测试矩阵结果写入CSV文件\n"
+         << "  --json=FILE              把测试矩阵结果写入JSON文件\n"
+         << "  --compare=FILE           与之前--csv保存的基线比较，有显著退化时返回码为2\n"
+         << "  --threshold=PCT          判为退化的最小变慢幅度（默认5%）\n"
+         << "  --min-score=S            排序前丢弃置信度低于S的框（默认0，不过滤）\n"
+         << "  --seed=N                 数据生成种子（默认" << DataGenerator::seed() << "）\n"
+         << "  --save-data=DIR          把测试矩阵的输入数据以二进制格式保存到DIR\n"
+         << "  --load-data=DIR          从DIR读取--save-data保存的输入数据，保证不同机器上输入完全相同\n"
+         << "  --make-capture=FILE      按--sizes和--dists生成捕获文件（每个组合--frames帧，默认100）后退出\n"
+         << "  --capture=FILE           映射捕获文件并逐帧执行NMS后退出\n"
+         << "  --pause                  结束前等待回车（双击运行时使用）\n"
+         << "  --help                   显示本帮助\n";
+}
+
+// 数值参数：整个字符串都必须是合法的数，atof/atoi会把"abc"或"5x"当成0或5，这里一律拒绝
+bool parseFloatValue(const string& text, float& value) {
+    if (text.empty()) return false;
+    char* end = NULL;
+    errno = 0;
+    value = strtof(text.c_str(), &end);
+    return *end == '\0' && errno == 0 && value == value;  // value != value 即NaN
+}
+
+bool parseDoubleValue(const string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = NULL;
+    errno = 0;
+    value = strtod(text.c_str(), &end);
+    return *end == '\0' && errno == 0 && value == value;
+}
+
+bool parseIntValue(const string& text, int& value) {
+    if (text.empty()) return false;
+    char* end = NULL;
+    errno = 0;
+    long number = strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || errno != 0 || number < INT_MIN || number > INT_MAX) return false;
+    value = (int)number;
+    return true;
+}
+
+// 解析命令行，参数有误时输出错误信息并返回false
+bool parseArguments(int argc, char* argv[], BenchmarkConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string key = arg, value;
+        size_t eq = arg.find('=');
+        if (eq != string::npos) {
+            key = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+        }
+        
+        if (key == "--help" || key == "-h") {
+            printUsage(argv[0]);
+            return false;
+        } else if (key == "--pause") {
+            config.pause = true;
+        } else if (key == "--csv" || key == "--json" || key == "--compare") {
+            if (value.empty()) {
+                cerr << "Error: " << key << " requires a file name" << endl;
+                return false;
+            }
+            if (key == "--csv") config.csvPath = value;
+            else if (key == "--json") config.jsonPath = value;
+            else config.comparePath = value;
+        } else if (key == "--capture" || key == "--make-capture") {
+            if (value.empty()) {
+                cerr << "Error: " << key << " requires a file name" << endl;
+                return false;
+            }
+            if (key == "--capture") config.capturePath = value;
+            else config.makeCapturePath = value;
+        } else if (key == "--save-data" || key == "--load-data") {
+            if (value.empty()) {
+                cerr << "Error: " << key << " requires a directory" << endl;
+                return false;
+            }
+            if (key == "--save-data") config.saveDataDir = value;
+            else config.loadDataDir = value;
+        } else if (key == "--seed") {
+            char* end = NULL;
+            config.seed = strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0') {
+                cerr << "Error: invalid value for --seed: '" << value << "'" << endl;
+                return false;
+            }
+        } else if (key == "--threshold") {
+            if (!parseDoubleValue(value, config.regressionThreshold) || config.regressionThreshold < 0) {
+                cerr << "Error: invalid value for --threshold: '" << value << "'" << endl;
+                return false;
+            }
+        } else if (key == "--min-score") {
+            if (!parseFloatValue(value, config.minScore) || config.minScore < 0 || config.minScore > 1) {
+                cerr << "Error: invalid value for --min-score: '" << value << "'" << endl;
+                return false;
+            }
+        } else if (key == "--sizes") {
+            config.sizes.clear();
+            vector<string> items = splitList(value);
+            for (int k = 0; k < (int)items.size(); k++) {
+                int size;
+                if (!parseIntValue(items[k], size) || size <= 0) {
+                    cerr << "Error: invalid size '" << items[k] << "'" << endl;
+                    return false;
+                }
+                config.sizes.push_back(size);
+            }
+            config.customSizes = true;
+        } else if (key == "--dists") {
+            config.distributions = splitList(value);
+            for (int k = 0; k < (int)config.distributions.size(); k++) {
+                if (!isKnownDistribution(config.distributions[k])) {
+                    cerr << "Error: unknown distribution '" << config.distributions[k] << "'" << endl;
+                    return false;
+                }
+            }
+        } else if (key == "--algos") {
+            config.sortTypes.clear();
+            vector<string> items = splitList(value);
+            for (int k = 0; k < (int)items.size(); k++) {
+                int code = findCode(SORT_CODES, NUM_SORT_CODES, items[k]);
+                if (code < 0) {
+                    cerr << "Error: unknown sort algorithm '" << items[k] << "'" << endl;
+                    return false;
+                }
+                config.sortTypes.push_back(code);
+            }
+            config.customAlgos = true;
+        } else if (key == "--nms") {
+            config.nmsTypes.clear();
+            vector<string> items = splitList(value);
+            for (int k = 0; k < (int)items.size(); k++) {
+                int code = findCode(NMS_CODES, NUM_NMS_CODES, items[k]);
+                if (code < 0) {
+                    cerr << "Error: unknown NMS algorithm '" << items[k] << "'" << endl;
+                    return false;
+                }
+                config.nmsTypes.push_back(code);
+            }
+        } else if (key == "--suites") {
+            config.suites = splitList(value);
+            for (int k = 0; k < (int)config.suites.size(); k++) {
+                const string& suite = config.suites[k];
+                if (suite != "all" && suite != "none" && findCode(SUITE_CODES, NUM_SUITE_CODES, suite) < 0) {
+                    cerr << "Error: unknown suite '" << suite << "'" << endl;
+                    return false;
+                }
+            }
+        } else if (key == "--reps" || key == "--warmup" || key == "--threads" || key == "--frames") {
+            int number;
+            if (!parseIntValue(value, number) || number < (key == "--warmup" ? 0 : 1)) {
+                cerr << "Error: invalid value for " << key << ": '" << value << "'" << endl;
+                return false;
+            }
+            if (key == "--reps") config.repetitions = number;
+            else if (key == "--warmup") config.warmup = number;
+            else if (key == "--frames") config.frames = number;
+            else config.threads = number;
+        } else {
+            cerr << "Error: unknown option '" << arg << "'（使用--help查看用法）" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool suiteEnabled(const BenchmarkConfig& config, const string& suite) {
+    for (int i = 0; i < (int)config.suites.size(); i++) {
+        if (config.suites[i] == "all" || config.suites[i] == suite) return true;
+    }
+    return false;
+}
+
+// --make-capture：每个规模×分布生成config.frames帧，写成一个已排序的捕获文件
+bool makeCaptureFile(const BenchmarkConfig& config) {
+    vector<vector<BoundingBox>> frames;
+    for (int i = 0; i < (int)config.sizes.size(); i++) {
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            Distribution dist = (Distribution)findCode(DIST_CODES, NUM_DIST_CODES, config.distributions[d]);
+            for (int f = 0; f < config.frames; f++) {
+                frames.push_back(DataGenerator::generate(dist, config.sizes[i], config.threads, f));
+            }
+        }
+    }
+    if (!writeBoxCapture(config.makeCapturePath, frames)) return false;
+    cout << "已写入 " << config.makeCapturePath << ": " << frames.size() << "帧\n";
+    return true;
+}
+
+// --capture：映射文件后逐帧执行NMS，输出吞吐量
+bool replayCaptureFile(const BenchmarkConfig& config) {
+    HighResTimer timer;
+    BoxCaptureReader reader;
+    if (!reader.open(config.capturePath)) return false;
+    double openTime = timer.elapsedMilliseconds();
+
+    FrameArena arena;
+    long long keptTotal = 0;
+    timer.start();
+    replayCapture(reader, arena, 0.5f, [&](uint64_t, const int*, int count) { keptTotal += count; });
+    double elapsed = timer.elapsedMilliseconds();
+
+    cout << config.capturePath << ": " << reader.frameCount() << "帧, " << reader.boxCount() << "个框"
+         << (reader.sorted() ? "（已排序）" : "（未排序）") << ", " << fixed << setprecision(1)
+         << reader.fileSize() / 1048576.0 << " MB\n"
+         << "映射: " << setprecision(3) << openTime << " ms, NMS: " << elapsed << " ms ("
+         << setprecision(1) << reader.frameCount() * 1000.0 / elapsed << " 帧/秒, "
+         << setprecision(2) << reader.boxCount() / elapsed / 1000.0 << " M框/秒), 共保留" << keptTotal << "个框\n";
+    return true;
+}
+
+// 插桩版本中每个测试结果下方的计数器明细
+void printPhaseCounters(const PerformanceResult& result) {
+    const PhaseCounters& sortC = result.sortCounters;
+    const PhaseCounters& nmsC = result.nmsCounters;
+    cout << "      排序: 比较" << sortC.hotPath[CNT_COMPARE] << "次, 交换/移动" << sortC.hotPath[CNT_SWAP]
+         << "次, 搬动" << sortC.hotPath[CNT_BYTES] / 1024 << " KB"
+         << " | NMS: IoU" << nmsC.hotPath[CNT_IOU] << "次(不相交提前返回" << nmsC.hotPath[CNT_EARLY_REJECT]
+         << "), 抑制" << nmsC.hotPath[CNT_SUPPRESS] << "个, 搬动" << nmsC.hotPath[CNT_BYTES] / 1024 << " KB\n";
+    if (sortC.hasHardware) {
+        const PhaseCounters* phases[] = {&sortC, &nmsC};
+        const char* names[] = {"排序", "NMS"};
+        cout << "     ";
+        for (int p = 0; p < 2; p++) {
+            cout << " " << names[p] << ": 周期" << phases[p]->hardware[HW_CYCLES]
+                 << ", 缓存未命中" << phases[p]->hardware[HW_CACHE_MISSES]
+                 << ", 分支预测失败" << phases[p]->hardware[HW_BRANCH_MISSES] << (p == 0 ? " |" : "\n");
+        }
+    }
+}
+
+// 规模 × 分布 × 排序算法 × NMS算法 的基本测试矩阵
+vector<PerformanceResult> runBenchmarkMatrix(const BenchmarkConfig& config) {
+    vector<PerformanceResult> allResults;
+    
+    // 算法名称
+    string algoNames[] = {"快速排序", "归并排序", "堆排序", "插入排序", "基数排序", "桶排序", "索引排序",
+                          "并行快速排序", "并行归并排序", "pdqSort", "自适应排序"};
+    
+    cout << "开始性能测试（每个测试预热" << config.warmup << "次，计时" << config.repetitions
+         << "次取中位数）...\n\n";
+    
+    for (int i = 0; i < (int)config.sizes.size(); i++) {
+        int size = config.sizes[i];
+        
+        cout << "测试数据规模: " << size << "个边界框\n";
+        
+        for (int d = 0; d < (int)config.distributions.size(); d++) {
+            const string& dist = config.distributions[d];
+            // 默认设置下聚集分布只测试中等数据量
+            if (dist == "clustered" && !config.customSizes && size > 2000) continue;
+            
+            string distName = distributionName(dist);
+            cout << "  " << distName << "测试:\n";
+            vector<BoundingBox> boxes;
+            if (!prepareBoxes(config, dist, size, boxes)) continue;
+            
+            for (int a = 0; a < (int)config.sortTypes.size(); a++) {
+                int algo = config.sortTypes[a];
+                // 默认设置下插入排序只测试小数据集
+                if (algo == 3 && !config.customAlgos && (size > 1000 || dist == "clustered")) continue;
+                
+                for (int k = 0; k < (int)config.nmsTypes.size(); k++) {
+                    TestOptions options(config.nmsTypes[k], config.threads);
+                    options.sortThreads = config.threads;
+                    options.minScore = config.minScore;
+                    PerformanceResult result = runTest(boxes, algo, algoNames[algo], distName,
+                                                       config.repetitions, options, config.warmup);
+                    result.distributionKey = dist;
+                    allResults.push_back(result);
+                    
+                    cout << "    " << algoNames[algo];
+                    if (config.nmsTypes.size() > 1) cout << " + " << result.nmsAlgorithm;
+                    cout << ": " << fixed << setprecision(3) << result.totalTime << " ms"
+                         << " (p95:" << result.totalStats.p95 << ", 标准差:" << result.totalStats.stddev << "), "
+                         << "保留" << result.remainingBoxes << "个框"
+                         << " (排序:" << result.sortTime << " ms, NMS:" << result.nmsTime << " ms)\n";
+                    if (HOT_PATH_INSTRUMENTED) printPhaseCounters(result);
+                }
+            }
+        }
+        
+        cout << endl;
+    }
+    
+    return allResults;
+}
+
+void printResultTable(const vector<PerformanceResult>& allResults) {
+    // 输出结果表格
+    cout << "\n============================================\n";
+    cout << "             性能测试结果汇总               \n";
+    cout << "============================================\n";
+    cout << left << setw(14) << "算法" 
+         << setw(16) << "NMS"
+         << setw(8) << "数据量" 
+         << setw(12) << "分布类型" 
          << setw(14) << "排序时间(ms)" 
          << setw(14) << "NMS时间(ms)" 
          << setw(14) << "总时间(ms)" 
+         << setw(12) << "P95(ms)"
+         << setw(12) << "P99(ms)"
+         << setw(12) << "标准差(ms)"
          << setw(10) << "保留框数" 
          << endl;
-    cout << string(88, '-') << endl;
+    cout << string(138, '-') << endl;
     
     for (int i = 0; i < allResults.size(); i++) {
         const PerformanceResult& r = allResults[i];
-        cout << left << setw(12) << r.sortAlgorithm
+        cout << left << setw(14) << r.sortAlgorithm
+             << setw(16) << r.nmsAlgorithm
              << setw(8) << r.numBoxes
              << setw(12) << r.distribution
              << fixed << setprecision(3)
              << setw(14) << r.sortTime
              << setw(14) << r.nmsTime
              << setw(14) << r.totalTime
+             << setw(12) << r.totalStats.p95
+             << setw(12) << r.totalStats.p99
+             << setw(12) << r.totalStats.stddev
              << setw(10) << r.remainingBoxes
              << endl;
     }
+    cout << right;
+}
+
+// 根据测试矩阵的实际结果总结观察到的现象（只比较与第一项相同的NMS算法，各排序算法的结果才可比）
+void printObservations(const vector<PerformanceResult>& allResults) {
+    cout << "\n观察到的现象:\n";
+    if (allResults.empty()) {
+        cout << "（未运行测试矩阵）\n";
+        return;
+    }
+    
+    int nmsType = allResults[0].nmsType;
+    map<string, int> keptByCase;
+    map<string, vector<const PerformanceResult*>> byDistribution;
+    bool sameKept = true;
+    for (size_t i = 0; i < allResults.size(); i++) {
+        const PerformanceResult& r = allResults[i];
+        string key = r.distributionKey + "/" + to_string(r.numBoxes) + "/" + to_string(r.nmsType);
+        map<string, int>::iterator it = keptByCase.find(key);
+        if (it == keptByCase.end()) keptByCase[key] = r.remainingBoxes;
+        else if (it->second != r.remainingBoxes) sameKept = false;
+        if (r.nmsType == nmsType) byDistribution[r.distribution].push_back(&r);
+    }
+    cout << "1. 相同规模、分布和NMS算法下，各排序算法保留的框数" << (sameKept ? "相同" : "不同！") << "\n";
+    
+    // 各分布最小和最大规模下的保留比例，以及最大规模下最快和最慢的排序算法
+    cout << "2. 保留框比例（" << allResults[0].nmsAlgorithm << "）:\n";
+    for (map<string, vector<const PerformanceResult*>>::iterator it = byDistribution.begin();
+         it != byDistribution.end(); ++it) {
+        const vector<const PerformanceResult*>& rs = it->second;
+        const PerformanceResult* smallest = rs[0];
+        const PerformanceResult* largest = rs[0];
+        for (size_t i = 1; i < rs.size(); i++) {
+            if (rs[i]->numBoxes < smallest->numBoxes) smallest = rs[i];
+            if (rs[i]->numBoxes > largest->numBoxes) largest = rs[i];
+        }
+        cout << "   " << it->first << ": " << fixed << setprecision(1) << smallest->numBoxes << "个框 "
+             << 100.0 * smallest->remainingBoxes / smallest->numBoxes << "%";
+        if (largest->numBoxes != smallest->numBoxes) {
+            cout << " -> " << largest->numBoxes << "个框 " << 100.0 * largest->remainingBoxes / largest->numBoxes << "%";
+        }
+        cout << "\n";
+    }
+    cout << "3. 各分布最大规模下的排序时间（中位数）:\n";
+    for (map<string, vector<const PerformanceResult*>>::iterator it = byDistribution.begin();
+         it != byDistribution.end(); ++it) {
+        const vector<const PerformanceResult*>& rs = it->second;
+        int largestSize = 0;
+        for (size_t i = 0; i < rs.size(); i++) largestSize = max(largestSize, rs[i]->numBoxes);
+        const PerformanceResult* fastest = 0;
+        const PerformanceResult* slowest = 0;
+        for (size_t i = 0; i < rs.size(); i++) {
+            if (rs[i]->numBoxes != largestSize) continue;
+            if (!fastest || rs[i]->sortTime < fastest->sortTime) fastest = rs[i];
+            if (!slowest || rs[i]->sortTime > slowest->sortTime) slowest = rs[i];
+        }
+        cout << "   " << it->first << " " << largestSize << "个框: 最快 " << fastest->sortAlgorithm << " "
+             << setprecision(3) << fastest->sortTime << " ms, 最慢 " << slowest->sortAlgorithm << " "
+             << slowest->sortTime << " ms\n";
+    }
+}
+
+// ==================== 结果导出与基线比较 ====================
+// 运行环境信息，写在导出文件开头，便于比较时确认基线来自同样的机器和编译器
+struct HostInfo {
+    string hostName;
+    string os;
+    string compiler;
+    string simdKernel;
+    int hardwareThreads;
+    string timestamp;
+};
+
+HostInfo collectHostInfo() {
+    HostInfo info;
+    const char* host = getenv("COMPUTERNAME");   // Windows
+    if (!host) host = getenv("HOSTNAME");
+#ifndef _WIN32
+    char buffer[256] = {0};
+    if (!host && gethostname(buffer, sizeof(buffer) - 1) == 0) host = buffer;
+#endif
+    info.hostName = host ? host : "unknown";
+    
+#if defined(_WIN32)
+    info.os = "windows";
+#elif defined(__APPLE__)
+    info.os = "macos";
+#elif defined(__linux__)
+    info.os = "linux";
+#else
+    info.os = "unknown";
+#endif
+    
+    stringstream compiler;
+#if defined(__clang__)
+    compiler << "clang " << __clang_version__;
+#elif defined(__GNUC__)
+    compiler << "gcc " << __VERSION__;
+#elif defined(_MSC_VER)
+    compiler << "msvc " << _MSC_VER;
+#else
+    compiler << "unknown";
+#endif
+#ifdef NDEBUG
+    compiler << " NDEBUG";
+#endif
+#ifdef __OPTIMIZE__
+    compiler << " optimized";
+#endif
+    info.compiler = compiler.str();
+    info.simdKernel = simdKernelName();
+    info.hardwareThreads = thread::hardware_concurrency();
+    
+    time_t now = time(NULL);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    info.timestamp = stamp;
+    return info;
+}
+
+// 每个统计量在CSV/JSON中的字段名后缀
+const char* STAT_NAMES[] = {"mean", "median", "p95", "p99", "stddev", "min"};
+
+double statValue(const TimingStats& stats, int k) {
+    double values[] = {stats.mean, stats.median, stats.p95, stats.p99, stats.stddev, stats.min};
+    return values[k];
+}
+
+void setStatValue(TimingStats& stats, int k, double value) {
+    double* fields[] = {&stats.mean, &stats.median, &stats.p95, &stats.p99, &stats.stddev, &stats.min};
+    *fields[k] = value;
+}
+
+// CSV开头的元数据（每行"# key=value"），写出和与基线比较时共用
+vector<pair<string, string>> csvMetadata(const HostInfo& host, const BenchmarkConfig& config) {
+    vector<pair<string, string>> items;
+    ostringstream value;
+    auto add = [&](const string& key) {
+        items.push_back(make_pair(key, value.str()));
+        value.str("");
+    };
+    value << host.hostName; add("host");
+    value << host.os; add("os");
+    value << host.compiler; add("compiler");
+    value << host.simdKernel; add("simd");
+    value << host.hardwareThreads; add("hardware_threads");
+    value << host.timestamp; add("timestamp");
+    value << config.repetitions; add("repetitions");
+    value << config.warmup; add("warmup");
+    value << config.seed; add("seed");
+    value << config.minScore; add("min_score");
+    return items;
+}
+
+bool writeCSV(const string& path, const vector<PerformanceResult>& results, const HostInfo& host,
+              const BenchmarkConfig& config) {
+    ofstream out(path.c_str());
+    if (!out) {
+        cerr << "Error: cannot write " << path << endl;
+        return false;
+    }
+    
+    vector<pair<string, string>> metadata = csvMetadata(host, config);
+    for (size_t i = 0; i < metadata.size(); i++) {
+        out << "# " << metadata[i].first << "=" << metadata[i].second << "\n";
+    }
+    
+    out << "sort,nms,sort_threads,nms_threads,boxes,distribution,repetitions,remaining";
+    const char* phases[] = {"sort", "nms", "total"};
+    for (int p = 0; p < 3; p++) {
+        for (int k = 0; k < 6; k++) out << "," << phases[p] << "_" << STAT_NAMES[k];
+    }
+    // 插桩版本追加各阶段的计数列，硬件计数不可用时写-1
+    for (int p = 0; p < 2 && HOT_PATH_INSTRUMENTED; p++) {
+        for (int c = 0; c < NUM_HOT_COUNTERS; c++) out << "," << phases[p] << "_" << HOT_COUNTER_NAMES[c];
+        for (int c = 0; c < NUM_HW_COUNTERS; c++) out << "," << phases[p] << "_" << HW_COUNTER_NAMES[c];
+    }
+    out << "\n";
+    
+    out << setprecision(6) << fixed;
+    for (int i = 0; i < (int)results.size(); i++) {
+        const PerformanceResult& r = results[i];
+        out << sortCode(r.sortType) << "," << nmsCode(r.nmsType) << ","
+            << r.sortThreads << "," << r.nmsThreads << "," << r.numBoxes << ","
+            << r.distributionKey << "," << r.repetitions << "," << r.remainingBoxes;
+        const TimingStats* stats[] = {&r.sortStats, &r.nmsStats, &r.totalStats};
+        for (int p = 0; p < 3; p++) {
+            for (int k = 0; k < 6; k++) out << "," << statValue(*stats[p], k);
+        }
+        const PhaseCounters* counters[] = {&r.sortCounters, &r.nmsCounters};
+        for (int p = 0; p < 2 && HOT_PATH_INSTRUMENTED; p++) {
+            for (int c = 0; c < NUM_HOT_COUNTERS; c++) out << "," << counters[p]->hotPath[c];
+            for (int c = 0; c < NUM_HW_COUNTERS; c++) {
+                out << "," << (counters[p]->hasHardware ? counters[p]->hardware[c] : -1);
+            }
+        }
+        out << "\n";
+    }
+    return true;
+}
+
+string jsonString(const string& text) {
+    string escaped = "\"";
+    for (int i = 0; i < (int)text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\') escaped += '\\';
+        if ((unsigned char)c < 0x20) continue;
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+bool writeJSON(const string& path, const vector<PerformanceResult>& results, const HostInfo& host,
+               const BenchmarkConfig& config) {
+    ofstream out(path.c_str());
+    if (!out) {
+        cerr << "Error: cannot write " << path << endl;
+        return false;
+    }
+    
+    out << "{\n  \"metadata\": {\n"
+        << "    \"host\": " << jsonString(host.hostName) << ",\n"
+        << "    \"os\": " << jsonString(host.os) << ",\n"
+        << "    \"compiler\": " << jsonString(host.compiler) << ",\n"
+        << "    \"simd\": " << jsonString(host.simdKernel) << ",\n"
+        << "    \"hardware_threads\": " << host.hardwareThreads << ",\n"
+        << "    \"timestamp\": " << jsonString(host.timestamp) << ",\n"
+        << "    \"repetitions\": " << config.repetitions << ",\n"
+        << "    \"warmup\": " << config.warmup << ",\n"
+        << "    \"seed\": " << config.seed << ",\n"
+        << "    \"min_score\": " << config.minScore << "\n"
+        << "  },\n  \"results\": [\n";
+    
+    out << setprecision(6) << fixed;
+    const char* phases[] = {"sort", "nms", "total"};
+    for (int i = 0; i < (int)results.size(); i++) {
+        const PerformanceResult& r = results[i];
+        out << "    {\"sort\": " << jsonString(sortCode(r.sortType))
+            << ", \"nms\": " << jsonString(nmsCode(r.nmsType))
+            << ", \"sort_threads\": " << r.sortThreads
+            << ", \"nms_threads\": " << r.nmsThreads
+            << ", \"boxes\": " << r.numBoxes
+            << ", \"distribution\": " << jsonString(r.distributionKey)
+            << ", \"repetitions\": " << r.repetitions
+            << ", \"remaining\": " << r.remainingBoxes;
+        const TimingStats* stats[] = {&r.sortStats, &r.nmsStats, &r.totalStats};
+        for (int p = 0; p < 3; p++) {
+            out << ", \"" << phases[p] << "_ms\": {";
+            for (int k = 0; k < 6; k++) {
+                out << (k ? ", " : "") << "\"" << STAT_NAMES[k] << "\": " << statValue(*stats[p], k);
+            }
+            out << "}";
+        }
+        if (HOT_PATH_INSTRUMENTED) {
+            const PhaseCounters* counters[] = {&r.sortCounters, &r.nmsCounters};
+            for (int p = 0; p < 2; p++) {
+                out << ", \"" << phases[p] << "_counters\": {";
+                for (int c = 0; c < NUM_HOT_COUNTERS; c++) {
+                    out << (c ? ", " : "") << "\"" << HOT_COUNTER_NAMES[c] << "\": " << counters[p]->hotPath[c];
+                }
+                for (int c = 0; c < NUM_HW_COUNTERS && counters[p]->hasHardware; c++) {
+                    out << ", \"" << HW_COUNTER_NAMES[c] << "\": " << counters[p]->hardware[c];
+                }
+                out << "}";
+            }
+        }
+        out << "}" << (i + 1 < (int)results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+// 读取writeCSV写出的文件（按表头定位各列），metadata返回开头的"# key=value"行
+bool loadCSV(const string& path, vector<PerformanceResult>& results, map<string, string>& metadata) {
+    ifstream in(path.c_str());
+    if (!in) {
+        cerr << "Error: cannot read " << path << endl;
+        return false;
+    }
+    
+    vector<string> header;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (!line.empty() && line[0] == '#') {
+            size_t eq = line.find('=');
+            if (header.empty() && eq != string::npos) {
+                size_t keyBegin = line.find_first_not_of("# ");
+                metadata[line.substr(keyBegin, eq - keyBegin)] = line.substr(eq + 1);
+            }
+            continue;
+        }
+        if (line.empty()) continue;
+        
+        vector<string> cells;
+        stringstream ss(line);
+        string cell;
+        while (getline(ss, cell, ',')) cells.push_back(cell);
+        
+        if (header.empty()) {
+            header = cells;
+            continue;
+        }
+        if (cells.size() != header.size()) {
+            cerr << "Error: malformed line in " << path << ": " << line << endl;
+            return false;
+        }
+        
+        PerformanceResult r;
+        const char* phases[] = {"sort", "nms", "total"};
+        TimingStats* stats[] = {&r.sortStats, &r.nmsStats, &r.totalStats};
+        PhaseCounters* counters[] = {&r.sortCounters, &r.nmsCounters};
+        for (int c = 0; c < (int)header.size(); c++) {
+            const string& name = header[c];
+            const string& value = cells[c];
+            if (name == "sort") {
+                r.sortType = findCode(SORT_CODES, NUM_SORT_CODES, value);
+                r.sortAlgorithm = value;
+            } else if (name == "nms") {
+                r.nmsType = findCode(NMS_CODES, NUM_NMS_CODES, value);
+                r.nmsAlgorithm = value;
+            } else if (name == "sort_threads") r.sortThreads = atoi(value.c_str());
+            else if (name == "nms_threads") r.nmsThreads = atoi(value.c_str());
+            else if (name == "boxes") r.numBoxes = atoi(value.c_str());
+            else if (name == "distribution") r.distributionKey = value;
+            else if (name == "repetitions") r.repetitions = atoi(value.c_str());
+            else if (name == "remaining") r.remainingBoxes = atoi(value.c_str());
+            else {
+                for (int p = 0; p < 3; p++) {
+                    for (int k = 0; k < 6; k++) {
+                        if (name == string(phases[p]) + "_" + STAT_NAMES[k]) {
+                            setStatValue(*stats[p], k, atof(value.c_str()));
+                        }
+                    }
+                }
+                for (int p = 0; p < 2; p++) {
+                    for (int k = 0; k < NUM_HOT_COUNTERS; k++) {
+                        if (name == string(phases[p]) + "_" + HOT_COUNTER_NAMES[k]) {
+                            counters[p]->hotPath[k] = atoll(value.c_str());
+                        }
+                    }
+                    for (int k = 0; k < NUM_HW_COUNTERS; k++) {
+                        if (name == string(phases[p]) + "_" + HW_COUNTER_NAMES[k]) {
+                            counters[p]->hardware[k] = atoll(value.c_str());
+                            counters[p]->hasHardware = counters[p]->hardware[k] >= 0;
+                        }
+                    }
+                }
+            }
+        }
+        r.totalTime = r.totalStats.median;
+        results.push_back(r);
+    }
+    return true;
+}
+
+// 单侧t检验（α=0.05）的临界值，自由度超过30时用正态近似
+double tCritical95(double df) {
+    static const double table[] = {6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+                                   1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+                                   1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697};
+    int k = (int)df;
+    if (k < 1) k = 1;
+    return k <= 30 ? table[k - 1] : 1.645;
+}
+
+string resultKey(const PerformanceResult& r) {
+    stringstream key;
+    key << r.sortAlgorithm << "/" << r.nmsAlgorithm << "/" << r.sortThreads << "/" << r.nmsThreads
+        << "/" << r.numBoxes << "/" << r.distributionKey;
+    return key.str();
+}
+
+// 与基线逐项比较总时间：变慢超过thresholdPct且Welch t检验显著时判为退化，返回退化项数。
+// 基线来自不同的机器、编译器或种子时先给出警告，这时的比较结果只能作参考
+int compareWithBaseline(const vector<PerformanceResult>& current, const vector<PerformanceResult>& baseline,
+                        const map<string, string>& baselineMetadata,
+                        const vector<pair<string, string>>& currentMetadata, double thresholdPct) {
+    map<string, PerformanceResult> baseByKey;
+    for (size_t i = 0; i < baseline.size(); i++) {
+        baseByKey[resultKey(baseline[i])] = baseline[i];
+    }
+    
+    cout << "\n============================================\n";
+    cout << "             与基线比较（总时间）           \n";
+    cout << "============================================\n";
+    const char* mustMatch[] = {"host", "compiler", "simd", "seed"};
+    for (int k = 0; k < 4; k++) {
+        string mine = "unknown";
+        for (size_t i = 0; i < currentMetadata.size(); i++) {
+            if (currentMetadata[i].first == mustMatch[k]) mine = currentMetadata[i].second;
+        }
+        map<string, string>::const_iterator it = baselineMetadata.find(mustMatch[k]);
+        string base = it == baselineMetadata.end() ? "unknown" : it->second;
+        if (base != mine) {
+            cout << "  警告: 基线的" << mustMatch[k] << "为\"" << base << "\"，本次为\"" << mine
+                 << "\"，结果不可直接比较\n";
+        }
+    }
+    
+    int regressions = 0, compared = 0;
+    for (int i = 0; i < (int)current.size(); i++) {
+        PerformanceResult cur = current[i];
+        cur.sortAlgorithm = sortCode(cur.sortType);
+        cur.nmsAlgorithm = nmsCode(cur.nmsType);
+        map<string, PerformanceResult>::iterator it = baseByKey.find(resultKey(cur));
+        if (it == baseByKey.end()) continue;
+        const PerformanceResult& base = it->second;
+        compared++;
+        
+        double m1 = base.totalStats.mean, m2 = cur.totalStats.mean;
+        double change = m1 > 0 ? (m2 - m1) / m1 * 100 : 0;
+        
+        // Welch t检验：两组方差不必相等
+        int n1 = base.repetitions, n2 = cur.repetitions;
+        bool testable = n1 > 1 && n2 > 1;
+        double t = 0, df = 1;
+        if (testable) {
+            double v1 = base.totalStats.stddev * base.totalStats.stddev / n1;
+            double v2 = cur.totalStats.stddev * cur.totalStats.stddev / n2;
+            double se = sqrt(v1 + v2);
+            t = se > 0 ? (m2 - m1) / se : (m2 > m1 ? 1e9 : 0);
+            df = (v1 + v2) * (v1 + v2) / max(1e-30, v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1));
+        }
+        bool significant = testable && t > tCritical95(df);
+        bool regression = significant && change > thresholdPct;
+        if (regression) regressions++;
+        
+        if (regression || change > thresholdPct) {
+            cout << (regression ? "  [退化] " : "  [波动] ") << resultKey(cur) << ": "
+                 << fixed << setprecision(3) << m1 << " -> " << m2 << " ms ("
+                 << showpos << setprecision(1) << change << noshowpos << "%"
+                 << (testable ? ", t=" : "") ;
+            if (testable) cout << setprecision(2) << t;
+            cout << (testable ? "" : ", 样本不足无法检验") << ")\n";
+        }
+    }
+    
+    cout << "共比较" << compared << "项，显著退化" << regressions << "项（阈值" << thresholdPct << "%）\n";
+    return regressions;
+}
+
+// ==================== 主函数 ====================
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        return argc > 1 && (string(argv[1]) == "--help" || string(argv[1]) == "-h") ? 0 : 1;
+    }
+    DataGenerator::setSeed(config.seed);
+    if (!config.makeCapturePath.empty()) return makeCaptureFile(config) ? 0 : 1;
+    if (!config.capturePath.empty()) return replayCaptureFile(config) ? 0 : 1;
+    
+    cout << "============================================\n";
+    cout << "      NMS算法性能测试实验（修正版）        \n";
+    cout << "============================================\n\n";
+    
+    int exitCode = 0;
+    vector<PerformanceResult> allResults;
+    if (suiteEnabled(config, "matrix")) {
+        allResults = runBenchmarkMatrix(config);
+        printResultTable(allResults);
+        
+        HostInfo host = collectHostInfo();
+        if (!config.csvPath.empty() && writeCSV(config.csvPath, allResults, host, config)) {
+            cout << "\n结果已写入 " << config.csvPath << "\n";
+        }
+        if (!config.jsonPath.empty() && writeJSON(config.jsonPath, allResults, host, config)) {
+            cout << "结果已写入 " << config.jsonPath << "\n";
+        }
+        if (!config.comparePath.empty()) {
+            vector<PerformanceResult> baseline;
+            map<string, string> baselineMetadata;
+            if (!loadCSV(config.comparePath, baseline, baselineMetadata)) {
+                exitCode = 1;
+            } else if (compareWithBaseline(allResults, baseline, baselineMetadata, csvMetadata(host, config),
+                                           config.regressionThreshold) > 0) {
+                exitCode = 2;
+            }
+        }
+    }
+    
+    if (suiteEnabled(config, "speedup")) runNMSSpeedupTest(config);
+    if (suiteEnabled(config, "parallel-nms")) runParallelNMSTest(config);
+    if (suiteEnabled(config, "topk")) runTopKTest(config);
+    if (suiteEnabled(config, "multiclass")) runMultiClassNMSTest(config);
+    if (suiteEnabled(config, "sort")) runLargeSortTest(config);
+    if (suiteEnabled(config, "parallel-sort")) runParallelSortTest(config);
+    if (suiteEnabled(config, "stream")) runStreamingTest(config);
+    if (suiteEnabled(config, "datagen")) runDataGenerationTest(config);
+    if (suiteEnabled(config, "capture")) runCaptureTest(config);
+    if (suiteEnabled(config, "quant")) runQuantizedNMSTest(config);
+    if (suiteEnabled(config, "sweep")) runSweepNMSTest(config);
+    if (suiteEnabled(config, "sort-patterns")) runSortPatternTest(config);
     
     // 分析结果
     cout << "\n============================================\n";
     cout << "               实验结果分析                \n";
-    cout << "\n观察到的现象:\n";
-    cout << "1. 相同数据量下，不同算法应该保留相同数量的框（已验证）\n";
-    cout << "2. 聚集分布比随机分布保留的框更少（聚集导致更多重叠）\n";
-    cout << "3. 数据量增加，保留框比例减少\n";
-    cout << "4. 插入排序在>1000数据时效率明显下降\n";
-    cout << "5. 快速排序和堆排序在大数据量时表现最优\n";
+    printObservations(allResults);
     
     cout << "\n预期的时间复杂度趋势:\n";
     cout << "- 插入排序: O(n^2)，数据量翻倍时间约4倍\n";
     cout << "- 快速/归并/堆排序: O(n log n)，数据量翻倍时间约2.2倍\n";
+    cout << "- 基数/桶排序: O(n)，只移动(键, 下标)对，最后一次性收集框\n";
+    cout << "- 索引排序: 仍是O(n log n)，但比较和移动都只涉及16字节的键值对\n";
+    cout << "- 并行快速/归并排序: 大区间拆成任务交给线程池，小区间回退到顺序排序\n";
+    cout << "- pdqSort: 九数取中、识别已有序区间、坏划分过多时回退堆排序，有序/逆序/重复输入都保持O(n log n)\n";
+    cout << "- 自适应排序: 一遍扫描判断有序程度，有序直接返回、逆序直接反转，其余按规模选pdqSort或基数排序\n";
     cout << "- NMS部分: O(n^2)，是主要性能瓶颈\n";
+    cout << "- 网格NMS: 每个保留框只检查相邻格子中的候选框，大规模数据下显著快于原始NMS\n";
+    cout << "- SIMD NMS: 复杂度不变，但内层循环一次处理4/8个候选框，常数因子大幅降低\n";
+    cout << "- 位掩码并行NMS: IoU关系矩阵由多线程计算，只剩一次按位或的顺序扫描\n";
+    cout << "- Top-K NMS: 建堆O(n)，只为真正取出的候选框付出O(log n)，保留K个即停止\n";
+    cout << "- 分批类别NMS: 各类别互不影响，可并行处理；Soft-NMS不提前跳过，始终为O(n^2)\n";
+    cout << "- 流式NMS: 缓冲区跨帧复用，稳定状态下每帧零分配，排序与抑制在两个线程上重叠\n";
+    cout << "- 映射文件NMS: 已排序的捕获文件按列存放，SIMD内核直接读取映射内存，不解析也不拷贝\n";
+    cout << "- 定点NMS: int16坐标让一个向量装下两倍的候选框，比较inter*(p+q)与p*(面积和)省去除法\n";
+    cout << "- 扫描线NMS: 按x1排序后只检查x方向可能相交的候选框；预过滤在排序前就减少了参与排序和NMS的框数\n";
+    if (HOT_PATH_INSTRUMENTED) {
+        cout << "- 计数器（-DNMS_INSTRUMENT）: 排序的比较/交换次数与NMS的IoU次数体现复杂度，搬动字节数体现内存流量\n";
+    }
     
-    cout << "\n按任意键继续...";
-    cin.get();
-    return 0;
+    if (config.pause) {
+        cout << "\n按回车键继续...";
+        cin.get();
+    }
+    return exitCode;
 }